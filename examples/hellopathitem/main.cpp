@@ -41,6 +41,7 @@
 #include <QGuiApplication>
 #include <QQuickView>
 #include <QQmlEngine>
+#include <QQmlContext>
 #include <QNvPathRendering>
 
 int main(int argc, char **argv)
@@ -57,6 +58,10 @@ int main(int argc, char **argv)
         fmt.setSamples(4);
     v.setFormat(fmt);
 
+    // Antialiasing via the PathItems' own alpha fringe, as an alternative to --multisample.
+    const bool vertexAntialiasing = QCoreApplication::arguments().contains(QStringLiteral("--antialiasing"));
+    v.rootContext()->setContextProperty(QStringLiteral("vertexAntialiasing"), vertexAntialiasing);
+
     v.setResizeMode(QQuickView::SizeRootObjectToView);
     v.setSource(QUrl("qrc:/main.qml"));
     QObject::connect(v.engine(), &QQmlEngine::quit, qGuiApp, &QCoreApplication::quit);
@@ -38,6 +38,7 @@ Item {
             PathItem {
                 id: path
                 anchors.fill: parent
+                antialiasing: vertexAntialiasing
                 property real ex: 100
                 property real ey: 100
                 onExChanged: regen()
@@ -107,6 +108,7 @@ Item {
                 strokeColor: "blue"
                 fillColor: "lightGray"
                 strokeWidth: 2
+                antialiasing: vertexAntialiasing
                 function draw() {
                     moveTo(50, 50)
                     arcTo(20, 30, 60, 40, 60, 240)
@@ -132,6 +134,7 @@ Item {
                 strokeWidth: 2
                 strokeStyle: PathItem.DashLine
                 dashPattern: [ 1, 4 ]
+                antialiasing: vertexAntialiasing
                 function draw() {
                     moveTo(20, 30);
                     cubicTo(80, 0, 50, 50, 80, 80);
@@ -149,6 +152,7 @@ Item {
                 fillColor: fillEnabled ? "lightGray" : "transparent"
                 property bool fillEnabled: true
                 strokeWidth: 2
+                antialiasing: vertexAntialiasing
                 function draw() {
                     moveTo(90, 50);
                     for (var i = 1; i < 5; ++i)
@@ -175,6 +179,7 @@ Item {
             height: 100
             strokeColor: "yellow"
             strokeWidth: 16
+            antialiasing: vertexAntialiasing
             function draw() {
                 lineTo(50, 100)
                 lineTo(0, 100)
@@ -208,6 +213,7 @@ Item {
             strokeColor: "green"
             strokeWidth: 5
             fillColor: "transparent" // just an optimization
+            antialiasing: vertexAntialiasing
 
             MoveTo {
                 x: 10
@@ -233,6 +239,7 @@ Item {
             PathItem {
                 width: 100
                 height: 100
+                antialiasing: vertexAntialiasing
                 MoveTo { x: 20; y: 30 }
                 CubicTo { cy1: 0; cx2: 50; cy2: 50; ex: 80; ey: 80
                           SequentialAnimation on cx1 {
@@ -253,6 +260,7 @@ Item {
                 height: 100
                 strokeWidth: 5
                 strokeColor: "yellow"
+                antialiasing: vertexAntialiasing
                 property bool fillEnabled: false
                 fillColor: fillEnabled ? "green" : "transparent"
 
@@ -278,6 +286,7 @@ Item {
             width: 100
             height: 100
             strokeColor: "yellow"
+            antialiasing: vertexAntialiasing
             fillGradient: PathGradient {
                 x1: 0; y1: 0
                 x2: 80; y2: 0
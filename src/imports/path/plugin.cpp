@@ -72,6 +72,7 @@ public:
         qmlRegisterType<QQuickPathEllipse>(uri, 2, 0, "PathEllipse");
         qmlRegisterType<QQuickPathRectangle>(uri, 2, 0, "PathRectangle");
         qmlRegisterType<QQuickPathRoundedRectangle>(uri, 2, 0, "PathRoundedRectangle");
+        qmlRegisterType<QQuickPathSvg>(uri, 2, 0, "PathSvg");
     }
 };
 
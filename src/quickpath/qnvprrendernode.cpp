@@ -177,6 +177,10 @@ void QNvprPathRenderer::setPath(const QPainterPath &path)
     // ###
 }
 
+void QNvprPathRenderer::setFillRule(Qt::FillRule fillRule)
+{
+}
+
 void QNvprPathRenderer::setFillColor(const QColor &color, QQuickPathGradient *gradient)
 {
 }
@@ -207,7 +211,7 @@ void QNvprPathRenderer::setStrokeStyle(QQuickPathItem::StrokeStyle strokeStyle,
 {
 }
 
-void QNvprPathRenderer::endSync()
+void QNvprPathRenderer::endSync(bool async)
 {
 }
 
@@ -66,6 +66,7 @@ public:
 
     void beginSync() override;
     void setPath(const QPainterPath &path) override;
+    void setFillRule(Qt::FillRule fillRule) override;
     void setFillColor(const QColor &color, QQuickPathGradient *gradient) override;
     void setStrokeColor(const QColor &color) override;
     void setStrokeWidth(qreal w) override;
@@ -75,7 +76,7 @@ public:
     void setStrokeStyle(QQuickPathItem::StrokeStyle strokeStyle,
                         qreal dashOffset, const QVector<qreal> &dashPattern,
                         bool cosmeticStroke) override;
-    void endSync() override;
+    void endSync(bool async) override;
     void updatePathRenderNode() override;
 
 private:
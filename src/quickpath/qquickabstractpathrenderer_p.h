@@ -60,13 +60,44 @@ public:
     virtual ~QQuickAbstractPathRenderer() { }
 
     enum RenderFlag {
-        RenderReserved = 0x01
+        RenderReserved = 0x01,
+        // add a fringe with an alpha ramp around the edges (QQuickItem::antialiasing)
+        RenderAntialiased = 0x02,
+        // evaluate curves in the fragment shader instead of flattening them
+        RenderCurves = 0x04
     };
     Q_DECLARE_FLAGS(RenderFlags, RenderFlag)
 
+    enum Capability {
+        SupportsAsync = 0x01,
+        // geometry depends on the scale to device pixels, see setScale()
+        ScaleDependent = 0x02
+    };
+    Q_DECLARE_FLAGS(Capabilities, Capability)
+
+    virtual Capabilities capabilities() const { return 0; }
+
     // Gui thread
     virtual void beginSync() = 0;
     virtual void setPath(const QPainterPath &path) = 0;
+    // Optional. Like setPath() for a path with the same elements as the one set
+    // last, where only the positions of the elements in [first, last] changed.
+    // first is -1 when no position changed.
+    virtual void updatePath(const QPainterPath &path, int, int) { setPath(path); }
+    // Changes the fill rule of the path set last. Not called when setPath()
+    // gets the new rule in the same sync.
+    virtual void setFillRule(Qt::FillRule fillRule) = 0;
+    // Optional. Called after setPath() with the shapes the path consists of,
+    // or an empty list when the path is not made of primitives only.
+    virtual void setPrimitives(const QVector<QQuickPathPrimitive> &) { }
+    // Optional. The scale from item coordinates to device pixels the geometry
+    // should be generated for.
+    virtual void setScale(qreal) { }
+    // Optional. Only the part of the stroke between start and end, as a
+    // fraction of the path's length, is drawn.
+    virtual void setStrokeTrim(qreal, qreal) { }
+    // Optional. How solid fill and stroke colors get to the shaders.
+    virtual void setColorMode(QQuickPathItem::ColorMode) { }
     virtual void setFillColor(const QColor &color, QQuickPathGradient *gradient) = 0;
     virtual void setStrokeColor(const QColor &color) = 0;
     virtual void setStrokeWidth(qreal w) = 0;
@@ -76,13 +107,20 @@ public:
     virtual void setStrokeStyle(QQuickPathItem::StrokeStyle strokeStyle,
                                 qreal dashOffset, const QVector<qreal> &dashPattern,
                                 bool cosmeticStroke) = 0;
-    virtual void endSync() = 0;
+    virtual void endSync(bool async) = 0;
+    // Invoked on the gui thread when an asynchronous endSync() has finished
+    // producing the new geometry.
+    virtual void setAsyncCallback(void (*)(void *), void *) { }
+    // Optional. Invoked once per frame, after the animations advanced.
+    // Returns true when the renderer wants a sync although nothing changed.
+    virtual bool advanceFrame() { return false; }
 
     // Render thread
     virtual void updatePathRenderNode() = 0;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(QQuickAbstractPathRenderer::RenderFlags)
+Q_DECLARE_OPERATORS_FOR_FLAGS(QQuickAbstractPathRenderer::Capabilities)
 
 QT_END_NAMESPACE
 
@@ -36,16 +36,22 @@
 
 #include "qquickpathcommand_p.h"
 #include "qquickpathitem_p_p.h"
+#include "qquickpathsvgparser_p.h"
 
 QT_BEGIN_NAMESPACE
 
-#define UPDATE_PATH_ITEM QQuickPathItemPrivate::get(static_cast<QQuickPathItem *>(parent()))->handlePathCommandChange
+#define UPDATE_PATH_ITEM() QQuickPathItemPrivate::get(static_cast<QQuickPathItem *>(parent()))->handlePathCommandChange(this)
 
 QQuickPathCommand::QQuickPathCommand(QObject *parent)
     : QObject(parent)
 {
 }
 
+bool QQuickPathCommand::toPrimitive(QQuickPathPrimitive *) const
+{
+    return false;
+}
+
 QQuickPathMoveTo::QQuickPathMoveTo(QObject *parent)
     : QQuickPathCommand(parent),
       m_x(0),
@@ -561,6 +567,15 @@ void QQuickPathEllipse::addToPath(QPainterPath *path)
     path->addEllipse(QPointF(m_centerX, m_centerY), m_radiusX, m_radiusY);
 }
 
+bool QQuickPathEllipse::toPrimitive(QQuickPathPrimitive *primitive) const
+{
+    primitive->type = QQuickPathPrimitive::Ellipse;
+    primitive->rect = QRectF(m_centerX - m_radiusX, m_centerY - m_radiusY, 2 * m_radiusX, 2 * m_radiusY);
+    primitive->radiusX = m_radiusX;
+    primitive->radiusY = m_radiusY;
+    return true;
+}
+
 QQuickPathRectangle::QQuickPathRectangle(QObject *parent)
     : QQuickPathCommand(parent),
       m_x(0),
@@ -631,6 +646,15 @@ void QQuickPathRectangle::addToPath(QPainterPath *path)
     path->addRect(m_x, m_y, m_width, m_height);
 }
 
+bool QQuickPathRectangle::toPrimitive(QQuickPathPrimitive *primitive) const
+{
+    primitive->type = QQuickPathPrimitive::Rectangle;
+    primitive->rect = QRectF(m_x, m_y, m_width, m_height);
+    primitive->radiusX = 0;
+    primitive->radiusY = 0;
+    return true;
+}
+
 QQuickPathRoundedRectangle::QQuickPathRoundedRectangle(QObject *parent)
     : QQuickPathRectangle(parent),
       m_radiusX(0),
@@ -671,4 +695,38 @@ void QQuickPathRoundedRectangle::addToPath(QPainterPath *path)
     path->addRoundedRect(x(), y(), width(), height(), m_radiusX, m_radiusY);
 }
 
+bool QQuickPathRoundedRectangle::toPrimitive(QQuickPathPrimitive *primitive) const
+{
+    primitive->type = QQuickPathPrimitive::RoundedRectangle;
+    primitive->rect = QRectF(x(), y(), width(), height());
+    primitive->radiusX = m_radiusX;
+    primitive->radiusY = m_radiusY;
+    return true;
+}
+
+QQuickPathSvg::QQuickPathSvg(QObject *parent)
+    : QQuickPathCommand(parent)
+{
+}
+
+QString QQuickPathSvg::path() const
+{
+    return m_path;
+}
+
+void QQuickPathSvg::setPath(const QString &path)
+{
+    if (m_path != path) {
+        m_path = path;
+        emit pathChanged();
+        UPDATE_PATH_ITEM();
+    }
+}
+
+void QQuickPathSvg::addToPath(QPainterPath *path)
+{
+    if (!QQuickPathSvgParser::parse(m_path, path))
+        qWarning("PathSvg: invalid path data, ignoring everything after the error");
+}
+
 QT_END_NAMESPACE
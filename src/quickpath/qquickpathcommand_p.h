@@ -54,6 +54,22 @@
 
 QT_BEGIN_NAMESPACE
 
+// Closed-form description of a shape command. Renderers may use this to
+// generate the geometry directly instead of processing the path.
+struct QQuickPathPrimitive
+{
+    enum Type {
+        Rectangle,
+        RoundedRectangle,
+        Ellipse
+    };
+
+    Type type;
+    QRectF rect;
+    qreal radiusX;
+    qreal radiusY;
+};
+
 class QQUICKPATH_EXPORT QQuickPathCommand : public QObject
 {
     Q_OBJECT
@@ -62,6 +78,7 @@ public:
     QQuickPathCommand(QObject *parent = nullptr);
 
     virtual void addToPath(QPainterPath *path) = 0;
+    virtual bool toPrimitive(QQuickPathPrimitive *primitive) const;
 };
 
 class QQUICKPATH_EXPORT QQuickPathMoveTo : public QQuickPathCommand
@@ -316,6 +333,7 @@ public:
     void setRadiusY(qreal v);
 
     void addToPath(QPainterPath *path) override;
+    bool toPrimitive(QQuickPathPrimitive *primitive) const override;
 
 signals:
     void centerXChanged();
@@ -352,6 +370,7 @@ public:
     void setHeight(qreal h);
 
     void addToPath(QPainterPath *path) override;
+    bool toPrimitive(QQuickPathPrimitive *primitive) const override;
 
 signals:
     void xChanged();
@@ -381,6 +400,7 @@ public:
     void setRadiusY(qreal v);
 
     void addToPath(QPainterPath *path) override;
+    bool toPrimitive(QQuickPathPrimitive *primitive) const override;
 
 signals:
     void radiusXChanged();
@@ -391,6 +411,27 @@ private:
     qreal m_radiusY;
 };
 
+// A sequence of commands given in the SVG path data syntax.
+class QQUICKPATH_EXPORT QQuickPathSvg : public QQuickPathCommand
+{
+    Q_OBJECT
+    Q_PROPERTY(QString path READ path WRITE setPath NOTIFY pathChanged)
+
+public:
+    QQuickPathSvg(QObject *parent = nullptr);
+
+    QString path() const;
+    void setPath(const QString &path);
+
+    void addToPath(QPainterPath *path) override;
+
+signals:
+    void pathChanged();
+
+private:
+    QString m_path;
+};
+
 QT_END_NAMESPACE
 
 #endif
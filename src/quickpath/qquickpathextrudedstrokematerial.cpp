@@ -0,0 +1,159 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtQuickPath module
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qquickpathextrudedstrokematerial_p.h"
+#include <QOpenGLShaderProgram>
+
+QT_BEGIN_NAMESPACE
+
+#ifndef QT_NO_OPENGL
+
+QSGMaterialType QQuickPathExtrudedStrokeShader::type;
+
+QQuickPathExtrudedStrokeShader::QQuickPathExtrudedStrokeShader()
+{
+    setShaderSourceFile(QOpenGLShader::Vertex,
+                        QStringLiteral(":/qt-project.org/scenegraph/path/shaders/extrudedstroke.vert"));
+    setShaderSourceFile(QOpenGLShader::Fragment,
+                        QStringLiteral(":/qt-project.org/scenegraph/path/shaders/extrudedstroke.frag"));
+}
+
+void QQuickPathExtrudedStrokeShader::initialize()
+{
+    m_opacityLoc = program()->uniformLocation("opacity");
+    m_matrixLoc = program()->uniformLocation("matrix");
+    m_halfWidthLoc = program()->uniformLocation("halfWidth");
+    m_pixelSizeLoc = program()->uniformLocation("pixelSize");
+    m_antialiasingLoc = program()->uniformLocation("antialiasing");
+    m_dashPatternLoc = program()->uniformLocation("dashPattern");
+    m_dashCountLoc = program()->uniformLocation("dashCount");
+    m_dashPeriodLoc = program()->uniformLocation("dashPeriod");
+    m_dashOffsetLoc = program()->uniformLocation("dashOffset");
+    m_capStyleLoc = program()->uniformLocation("capStyle");
+    m_trimStartLoc = program()->uniformLocation("trimStart");
+    m_trimEndLoc = program()->uniformLocation("trimEnd");
+}
+
+void QQuickPathExtrudedStrokeShader::updateState(const RenderState &state, QSGMaterial *newEffect, QSGMaterial *oldEffect)
+{
+    QQuickPathExtrudedStrokeMaterial *m = static_cast<QQuickPathExtrudedStrokeMaterial *>(newEffect);
+    QQuickPathExtrudedStrokeMaterial *old = static_cast<QQuickPathExtrudedStrokeMaterial *>(oldEffect);
+    if (state.isOpacityDirty())
+        program()->setUniformValue(m_opacityLoc, state.opacity());
+    if (state.isMatrixDirty())
+        program()->setUniformValue(m_matrixLoc, state.combinedMatrix());
+    // the viewport may have changed, antialiased edges are grown by half a
+    // device pixel
+    const QRect r = state.viewportRect();
+    program()->setUniformValue(m_pixelSizeLoc, 2.0f / r.width(), 2.0f / r.height());
+    if (!old || old->m_strokeWidth != m->m_strokeWidth)
+        program()->setUniformValue(m_halfWidthLoc, m->m_strokeWidth / 2);
+    if (!old || old->m_antialiasing != m->m_antialiasing)
+        program()->setUniformValue(m_antialiasingLoc, m->m_antialiasing ? 1.0f : 0.0f);
+    if (!old || old->m_trimStart != m->m_trimStart || old->m_trimEnd != m->m_trimEnd) {
+        program()->setUniformValue(m_trimStartLoc, m->m_trimStart);
+        program()->setUniformValue(m_trimEndLoc, m->m_trimEnd);
+    }
+    if (!old || old->compare(m) != 0) {
+        float period = 0;
+        for (int i = 0; i < m->m_dashCount; ++i)
+            period += m->m_dashPattern[i];
+        program()->setUniformValueArray(m_dashPatternLoc, m->m_dashPattern, m->m_dashCount, 1);
+        program()->setUniformValue(m_dashCountLoc, m->m_dashCount);
+        program()->setUniformValue(m_dashPeriodLoc, period);
+        program()->setUniformValue(m_dashOffsetLoc, m->m_dashOffset);
+        program()->setUniformValue(m_capStyleLoc, float(m->m_capStyle));
+    }
+}
+
+char const *const *QQuickPathExtrudedStrokeShader::attributeNames() const
+{
+    static const char *const attr[] = { "vertexCoord", "vertexColor", "vertexOffset", "vertexLength", nullptr };
+    return attr;
+}
+
+int QQuickPathExtrudedStrokeMaterial::compare(const QSGMaterial *other) const
+{
+    const QQuickPathExtrudedStrokeMaterial *m = static_cast<const QQuickPathExtrudedStrokeMaterial *>(other);
+    if (m_strokeWidth != m->m_strokeWidth)
+        return m_strokeWidth < m->m_strokeWidth ? -1 : 1;
+    if (m_antialiasing != m->m_antialiasing)
+        return int(m_antialiasing) - int(m->m_antialiasing);
+    if (m_trimStart != m->m_trimStart)
+        return m_trimStart < m->m_trimStart ? -1 : 1;
+    if (m_trimEnd != m->m_trimEnd)
+        return m_trimEnd < m->m_trimEnd ? -1 : 1;
+    // the cap applies to the dashes and to the trimmed ends
+    if (m_capStyle != m->m_capStyle)
+        return m_capStyle - m->m_capStyle;
+    if (m_dashCount != m->m_dashCount)
+        return m_dashCount - m->m_dashCount;
+    if (!m_dashCount)
+        return 0;
+    if (m_dashOffset != m->m_dashOffset)
+        return m_dashOffset < m->m_dashOffset ? -1 : 1;
+    return memcmp(m_dashPattern, m->m_dashPattern, m_dashCount * sizeof(float));
+}
+
+bool QQuickPathExtrudedStrokeMaterial::setPen(const QPen &pen, qreal trimStart, qreal trimEnd, bool antialiasing)
+{
+    QQuickPathExtrudedStrokeMaterial m;
+    m.m_strokeWidth = pen.widthF();
+    m.m_antialiasing = antialiasing;
+    m.m_trimStart = trimStart;
+    m.m_trimEnd = trimEnd;
+    const QVector<qreal> pattern = pen.style() == Qt::SolidLine ? QVector<qreal>() : pen.dashPattern();
+    m.m_dashCount = qMin<int>(pattern.count(), MaxDashPattern);
+    for (int i = 0; i < m.m_dashCount; ++i)
+        m.m_dashPattern[i] = pattern.at(i);
+    m.m_dashOffset = pen.dashOffset();
+    m.m_capStyle = pen.capStyle() == Qt::SquareCap ? 1 : pen.capStyle() == Qt::RoundCap ? 2 : 0;
+    if (!compare(&m))
+        return false;
+    m_strokeWidth = m.m_strokeWidth;
+    m_antialiasing = m.m_antialiasing;
+    m_trimStart = m.m_trimStart;
+    m_trimEnd = m.m_trimEnd;
+    memcpy(m_dashPattern, m.m_dashPattern, m.m_dashCount * sizeof(float));
+    m_dashCount = m.m_dashCount;
+    m_dashOffset = m.m_dashOffset;
+    m_capStyle = m.m_capStyle;
+    return true;
+}
+
+#endif // QT_NO_OPENGL
+
+QT_END_NAMESPACE
@@ -0,0 +1,143 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtQuickPath module
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QQUICKPATHEXTRUDEDSTROKEMATERIAL_P_H
+#define QQUICKPATHEXTRUDEDSTROKEMATERIAL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of a number of Qt sources files.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuickPath/qtquickpathglobal.h>
+#include <qsgmaterial.h>
+#include <QPen>
+
+QT_BEGIN_NAMESPACE
+
+#ifndef QT_NO_OPENGL
+
+class QQuickPathExtrudedStrokeShader : public QSGMaterialShader
+{
+public:
+    QQuickPathExtrudedStrokeShader();
+
+    void initialize() override;
+    void updateState(const RenderState &state, QSGMaterial *newEffect, QSGMaterial *oldEffect) override;
+    char const *const *attributeNames() const override;
+
+    static QSGMaterialType type;
+
+private:
+    int m_opacityLoc;
+    int m_matrixLoc;
+    int m_halfWidthLoc;
+    int m_pixelSizeLoc;
+    int m_antialiasingLoc;
+    int m_dashPatternLoc;
+    int m_dashCountLoc;
+    int m_dashPeriodLoc;
+    int m_dashOffsetLoc;
+    int m_capStyleLoc;
+    int m_trimStartLoc;
+    int m_trimEndLoc;
+};
+
+// Per-vertex color, with the stroke width applied in the vertex shader and
+// the dash pattern and the trimming in the fragment shader. Strokes with the
+// same pen settings batch together.
+class QQuickPathExtrudedStrokeMaterial : public QSGMaterial
+{
+public:
+    // must match the array size in extrudedstroke.frag
+    enum { MaxDashPattern = 8 };
+
+    QQuickPathExtrudedStrokeMaterial()
+        : m_strokeWidth(1),
+          m_antialiasing(false),
+          m_dashCount(0),
+          m_dashOffset(0),
+          m_capStyle(0),
+          m_trimStart(0),
+          m_trimEnd(1)
+    {
+        // the offsets are in item coordinates, merged batches would not scale them
+        setFlag(Blending | RequiresFullMatrixExceptTranslate);
+    }
+
+    QSGMaterialType *type() const override
+    {
+        return &QQuickPathExtrudedStrokeShader::type;
+    }
+
+    int compare(const QSGMaterial *other) const override;
+
+    QSGMaterialShader *createShader() const override
+    {
+        return new QQuickPathExtrudedStrokeShader;
+    }
+
+    // Takes the width, the dash pattern and the cap style from the pen,
+    // trimStart and trimEnd are fractions of the path length.
+    // Returns true when anything changed.
+    bool setPen(const QPen &pen, qreal trimStart, qreal trimEnd, bool antialiasing);
+
+private:
+    float m_strokeWidth;
+    bool m_antialiasing;
+    // in stroke widths, dash and space lengths alternating
+    float m_dashPattern[MaxDashPattern];
+    int m_dashCount;
+    float m_dashOffset;
+    // 0 flat, 1 square, 2 round, applies to each dash and the trimmed ends
+    int m_capStyle;
+    float m_trimStart;
+    float m_trimEnd;
+
+    friend class QQuickPathExtrudedStrokeShader;
+};
+
+#endif // QT_NO_OPENGL
+
+QT_END_NAMESPACE
+
+#endif
@@ -35,10 +35,7 @@
 ****************************************************************************/
 
 #include "qquickpathgradientmaterial_p.h"
-#include <QQuickWindow>
 #include <QOpenGLFunctions>
-#include <QtQuick/private/qsgtexture_p.h>
-#include <QtGui/private/qdrawhelper_p.h>
 //#include <QImage>
 
 QT_BEGIN_NAMESPACE
@@ -60,100 +57,247 @@ private:
 
 Q_GLOBAL_STATIC(QQuickPathGradientCacheWrapper, qt_path_gradient_caches)
 
-// let QOpenGLContext manage the lifetime of the cached textures
-QQuickPathGradientCache::~QQuickPathGradientCache()
+// default budget when QT_QUICKPATH_GRADIENT_CACHE_SIZE (in kilobytes) is not set
+static const int DEFAULT_MAX_BYTES = 256 * 1024;
+
+static const int ROW_BYTES = QQuickPathGradientCache::RowWidth * sizeof(uint);
+
+// the GL_MAX_TEXTURE_SIZE every OpenGL ES 2.0 implementation supports
+static const int MIN_PAGE_ROWS = 64;
+
+QQuickPathGradientCache::QQuickPathGradientCache(QOpenGLContext *context)
+    : QOpenGLSharedResource(context->shareGroup()),
+      m_lruFirst(-1),
+      m_lruLast(-1),
+      m_pageRows(0),
+      m_hits(0),
+      m_misses(0),
+      m_evictions(0)
 {
-    m_cache.clear();
+    bool ok = false;
+    const int kb = qEnvironmentVariableIntValue("QT_QUICKPATH_GRADIENT_CACHE_SIZE", &ok);
+    m_maxBytes = ok ? qBound(0, kb, INT_MAX / 1024) * 1024 : DEFAULT_MAX_BYTES;
+
+    // The nodes ask for the cache while their context is current. The rows
+    // are assigned to pages before anything is uploaded, so the limit has
+    // to be known upfront.
+    GLint maxSize = 0;
+    if (QOpenGLContext::currentContext() == context)
+        context->functions()->glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    m_pageRows = qMax(MIN_PAGE_ROWS, int(maxSize));
 }
 
 void QQuickPathGradientCache::invalidateResource()
 {
-    m_cache.clear();
+    for (Page &page : m_pages) {
+        page.texture = 0;
+        page.textureRows = 0;
+    }
 }
 
-void QQuickPathGradientCache::freeResource(QOpenGLContext *)
+void QQuickPathGradientCache::freeResource(QOpenGLContext *context)
 {
-    qDeleteAll(m_cache);
-    m_cache.clear();
+    for (Page &page : m_pages) {
+        if (page.texture)
+            context->functions()->glDeleteTextures(1, &page.texture);
+        page.texture = 0;
+        page.textureRows = 0;
+    }
 }
 
-// ### borrowed from QtGui. May get replaced with something else later.
-static void generateGradientColorTable(const QQuickPathRenderer::GradientDesc &gradient, uint *colorTable, int size, float opacity)
+QQuickPathGradientCache *QQuickPathGradientCache::cacheForContext(QOpenGLContext *context)
 {
-    int pos = 0;
-    const QGradientStops &s = gradient.stops;
-    const bool colorInterpolation = true;
+    return qt_path_gradient_caches()->get(context);
+}
 
-    uint alpha = qRound(opacity * 256);
-    uint current_color = ARGB_COMBINE_ALPHA(s[0].second.rgba(), alpha);
-    qreal incr = 1.0 / qreal(size);
-    qreal fpos = 1.5 * incr;
-    colorTable[pos++] = ARGB2RGBA(qPremultiply(current_color));
+QQuickPathGradientCache *QQuickPathGradientCache::currentCache()
+{
+    return cacheForContext(QOpenGLContext::currentContext());
+}
 
-    while (fpos <= s.first().first) {
-        colorTable[pos] = colorTable[pos - 1];
-        pos++;
-        fpos += incr;
+int QQuickPathGradientCache::acquireRow(const QQuickPathRenderer::GradientTable &table)
+{
+    QMutexLocker lock(&m_mutex);
+    const quint64 hash = table.hash;
+    for (auto it = m_index.constFind(hash); it != m_index.cend() && it.key() == hash; ++it) {
+        Row &r(m_rows[it.value()]);
+        if (r.stops == table.stops) {
+            if (!r.ref++)
+                unlinkUnused(it.value());
+            ++m_hits;
+            return it.value();
+        }
+    }
+    ++m_misses;
+
+    int row;
+    if (m_lruFirst >= 0 && (m_rows.count() + 1) * ROW_BYTES > m_maxBytes) {
+        row = m_lruFirst;
+        unlinkUnused(row);
+        m_index.remove(m_rows[row].hash, row);
+        ++m_evictions;
+    } else {
+        row = m_rows.count();
+        m_rows.append(Row());
+        m_texels.resize(m_rows.count() * RowWidth);
     }
 
-    if (colorInterpolation)
-        current_color = qPremultiply(current_color);
-
-    const int sLast = s.size() - 1;
-    for (int i = 0; i < sLast; ++i) {
-        qreal delta = 1/(s[i+1].first - s[i].first);
-        uint next_color = ARGB_COMBINE_ALPHA(s[i + 1].second.rgba(), alpha);
-        if (colorInterpolation)
-            next_color = qPremultiply(next_color);
-
-        while (fpos < s[i+1].first && pos < size) {
-            int dist = int(256 * ((fpos - s[i].first) * delta));
-            int idist = 256 - dist;
-            if (colorInterpolation)
-                colorTable[pos] = ARGB2RGBA(INTERPOLATE_PIXEL_256(current_color, idist, next_color, dist));
-            else
-                colorTable[pos] = ARGB2RGBA(qPremultiply(INTERPOLATE_PIXEL_256(current_color, idist, next_color, dist)));
-            ++pos;
-            fpos += incr;
-        }
-        current_color = next_color;
+    Row &r(m_rows[row]);
+    r.stops = table.stops;
+    r.hash = hash;
+    r.ref = 1;
+    m_index.insert(hash, row);
+    // the table was generated on the gui thread, only the upload is left
+    if (table.texels.count() == RowWidth)
+        memcpy(m_texels.data() + row * RowWidth, table.texels.constData(), ROW_BYTES);
+    else
+        memset(m_texels.data() + row * RowWidth, 0, ROW_BYTES);
+    Page &page(pageForRow(row));
+    page.dirtyFirst = qMin(page.dirtyFirst, rowInPage(row));
+    page.dirtyLast = qMax(page.dirtyLast, rowInPage(row));
+    return row;
+}
+
+QQuickPathGradientCache::Page &QQuickPathGradientCache::pageForRow(int row)
+{
+    const int index = pageOf(row);
+    while (m_pages.count() <= index) {
+        Page page;
+        page.texture = 0;
+        page.textureRows = 0;
+        page.dirtyFirst = INT_MAX;
+        page.dirtyLast = -1;
+        m_pages.append(page);
     }
+    return m_pages[index];
+}
 
-    Q_ASSERT(s.size() > 0);
-
-    uint last_color = ARGB2RGBA(qPremultiply(ARGB_COMBINE_ALPHA(s[sLast].second.rgba(), alpha)));
-    for (;pos < size; ++pos)
-        colorTable[pos] = last_color;
-
-    colorTable[size-1] = last_color;
-}
-
-QSGTexture *QQuickPathGradientCache::get(const QQuickPathRenderer::GradientDesc &grad)
-{
-    QSGPlainTexture *tx = m_cache[grad];
-    if (!tx) {
-        QOpenGLFunctions *f = QOpenGLContext::currentContext()->functions();
-        GLuint id;
-        f->glGenTextures(1, &id);
-        f->glBindTexture(GL_TEXTURE_2D, id);
-        static const uint W = 1024; // texture size is 1024x1
-        uint buf[W];
-        generateGradientColorTable(grad, buf, W, 1.0f);
-//        QImage img(reinterpret_cast<const uchar *>(buf), W, 1, QImage::Format_RGBA8888_Premultiplied);
-//        img.save("a.png");
-        f->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, W, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, buf);
-        tx = new QSGPlainTexture;
-        tx->setTextureId(id);
-        if (grad.spread == QQuickPathGradient::RepeatSpread) {
-            tx->setHorizontalWrapMode(QSGTexture::Repeat);
-            tx->setVerticalWrapMode(QSGTexture::Repeat);
-        } else {
-            tx->setHorizontalWrapMode(QSGTexture::ClampToEdge);
-            tx->setVerticalWrapMode(QSGTexture::ClampToEdge);
-        }
-        m_cache[grad] = tx;
+void QQuickPathGradientCache::releaseRow(int row)
+{
+    QMutexLocker lock(&m_mutex);
+    if (row >= 0 && row < m_rows.count() && m_rows[row].ref > 0 && !--m_rows[row].ref)
+        linkUnused(row);
+}
+
+void QQuickPathGradientCache::linkUnused(int row)
+{
+    Row &r(m_rows[row]);
+    r.lruPrev = m_lruLast;
+    r.lruNext = -1;
+    if (m_lruLast >= 0)
+        m_rows[m_lruLast].lruNext = row;
+    else
+        m_lruFirst = row;
+    m_lruLast = row;
+}
+
+void QQuickPathGradientCache::unlinkUnused(int row)
+{
+    Row &r(m_rows[row]);
+    if (r.lruPrev >= 0)
+        m_rows[r.lruPrev].lruNext = r.lruNext;
+    else
+        m_lruFirst = r.lruNext;
+    if (r.lruNext >= 0)
+        m_rows[r.lruNext].lruPrev = r.lruPrev;
+    else
+        m_lruLast = r.lruPrev;
+    r.lruPrev = r.lruNext = -1;
+}
+
+int QQuickPathGradientCache::maxBytes() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_maxBytes;
+}
+
+// A smaller budget takes effect as new stops come in, the texture does not
+// shrink.
+void QQuickPathGradientCache::setMaxBytes(int bytes)
+{
+    QMutexLocker lock(&m_mutex);
+    m_maxBytes = qMax(0, bytes);
+}
+
+int QQuickPathGradientCache::totalBytes() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_rows.count() * ROW_BYTES;
+}
+
+int QQuickPathGradientCache::hits() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_hits;
+}
+
+int QQuickPathGradientCache::misses() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_misses;
+}
+
+int QQuickPathGradientCache::evictions() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_evictions;
+}
+
+void QQuickPathGradientCache::resetCounters()
+{
+    QMutexLocker lock(&m_mutex);
+    m_hits = 0;
+    m_misses = 0;
+    m_evictions = 0;
+}
+
+int QQuickPathGradientCache::textureRows(int page) const
+{
+    QMutexLocker lock(&m_mutex);
+    return page >= 0 && page < m_pages.count() ? m_pages[page].textureRows : 0;
+}
+
+void QQuickPathGradientCache::bind(int pageIndex)
+{
+    QMutexLocker lock(&m_mutex);
+    QOpenGLFunctions *f = QOpenGLContext::currentContext()->functions();
+    Page &page(pageForRow(pageIndex * m_pageRows));
+    if (!page.texture) {
+        f->glGenTextures(1, &page.texture);
+        f->glBindTexture(GL_TEXTURE_2D, page.texture);
+        f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        // the spread is applied in the shaders
+        f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        page.textureRows = 0;
+    } else {
+        f->glBindTexture(GL_TEXTURE_2D, page.texture);
+    }
+
+    const int firstRow = pageIndex * m_pageRows;
+    const int pageRowCount = qBound(0, m_rows.count() - firstRow, m_pageRows);
+    if (pageRowCount > page.textureRows) {
+        // Grow in steps so that new gradients do not reallocate every time.
+        // Everything gets uploaded again, the vertices refer to rows by index
+        // and the shader gets the new height.
+        int rows = qMax(16, page.textureRows);
+        while (rows < pageRowCount)
+            rows *= 2;
+        rows = qMin(rows, m_pageRows);
+        f->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, RowWidth, rows, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        page.textureRows = rows;
+        page.dirtyFirst = 0;
+        page.dirtyLast = pageRowCount - 1;
+    }
+
+    if (page.dirtyFirst <= page.dirtyLast) {
+        f->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, page.dirtyFirst, RowWidth, page.dirtyLast - page.dirtyFirst + 1,
+                           GL_RGBA, GL_UNSIGNED_BYTE,
+                           m_texels.constData() + (firstRow + page.dirtyFirst) * RowWidth);
+        page.dirtyFirst = INT_MAX;
+        page.dirtyLast = -1;
     }
-    return tx;
 }
 
 QSGMaterialType QQuickPathLinearGradientShader::type;
@@ -170,78 +314,35 @@ void QQuickPathLinearGradientShader::initialize()
 {
     m_opacityLoc = program()->uniformLocation("opacity");
     m_matrixLoc = program()->uniformLocation("matrix");
-    m_viewportSizeLoc = program()->uniformLocation("viewportSize");
-    m_gradStartLoc = program()->uniformLocation("gradStart");
-    m_gradEndLoc = program()->uniformLocation("gradEnd");
+    m_textureRowsLoc = program()->uniformLocation("textureRows");
 }
 
-void QQuickPathLinearGradientShader::updateState(const RenderState &state, QSGMaterial *mat, QSGMaterial *)
+void QQuickPathLinearGradientShader::updateState(const RenderState &state, QSGMaterial *newEffect, QSGMaterial *)
 {
-    QQuickPathLinearGradientMaterial *m = static_cast<QQuickPathLinearGradientMaterial *>(mat);
     if (state.isOpacityDirty())
         program()->setUniformValue(m_opacityLoc, state.opacity());
     if (state.isMatrixDirty())
         program()->setUniformValue(m_matrixLoc, state.combinedMatrix());
-    QQuickPathRenderer *r = m->node()->rootNode()->renderer();
-    if (r) {
-        if (m->node()->dirty() & QQuickPathRenderer::DirtyColor) {
-            program()->setUniformValue(m_gradStartLoc, r->fillGradient()->start);
-            program()->setUniformValue(m_gradEndLoc, r->fillGradient()->end);
-        }
-        // the window size may have changed, set the corresponding uniform always
-        QQuickWindow *w = m->node()->window();
-        const QSize sz = w->size() * w->effectiveDevicePixelRatio();
-        const QVector2D viewportSize(sz.width(), sz.height());
-        program()->setUniformValue(m_viewportSizeLoc, viewportSize);
-        // (re)generate color table and bind the texture
-        QSGTexture *tx = qt_path_gradient_caches()->get(QOpenGLContext::currentContext())->get(*r->fillGradient());
-        tx->bind();
-    }
-    m->node()->resetDirty();
+    // upload new color tables, the texture may have grown as well
+    const int page = static_cast<QQuickPathLinearGradientMaterial *>(newEffect)->page();
+    QQuickPathGradientCache *cache = QQuickPathGradientCache::currentCache();
+    cache->bind(page);
+    program()->setUniformValue(m_textureRowsLoc, float(cache->textureRows(page)));
 }
 
 char const *const *QQuickPathLinearGradientShader::attributeNames() const
 {
-    static const char *const attr[] = { "vertexCoord", "vertexColor", nullptr };
+    static const char *const attr[] = { "vertexCoord", "vertexGradient", nullptr };
     return attr;
 }
 
+// The gradient is in the vertices and the color tables are rows of the same
+// texture, so only fills with tables on different pages are not batched.
 int QQuickPathLinearGradientMaterial::compare(const QSGMaterial *other) const
 {
     Q_ASSERT(other && type() == other->type());
     const QQuickPathLinearGradientMaterial *m = static_cast<const QQuickPathLinearGradientMaterial *>(other);
-
-    QQuickPathRenderer *a = node()->rootNode()->renderer();
-    QQuickPathRenderer *b = m->node()->rootNode()->renderer();
-    if (a == b)
-        return 0;
-    if (!a)
-        return -1;
-    if (!b)
-        return 1;
-
-    const QQuickPathRenderer::GradientDesc *ga = a->fillGradient();
-    const QQuickPathRenderer::GradientDesc *gb = b->fillGradient();
-    if (int d = ga->start.x() - gb->start.x())
-        return d;
-    if (int d = ga->start.y() - gb->start.y())
-        return d;
-    if (int d = ga->end.x() - gb->end.x())
-        return d;
-    if (int d = ga->end.y() - gb->end.y())
-        return d;
-
-    if (int d = ga->stops.count() - gb->stops.count())
-        return d;
-
-    for (int i = 0; i < ga->stops.count(); ++i) {
-        if (int d = ga->stops[i].first - gb->stops[i].first)
-            return d;
-        if (int d = ga->stops[i].second.rgba() - gb->stops[i].second.rgba())
-            return d;
-    }
-
-    return 0;
+    return m_page - m->m_page;
 }
 
 #endif // QT_NO_OPENGL
@@ -52,30 +52,103 @@
 #include <qsgmaterial.h>
 #include <QtGui/private/qopenglcontext_p.h>
 #include "qquickpathrendernode_p.h"
+#include <QMultiHash>
+#include <QMutex>
+#include <climits>
 
 QT_BEGIN_NAMESPACE
 
 #ifndef QT_NO_OPENGL
 
-class QSGTexture;
-class QSGPlainTexture;
-
-class QQuickPathGradientCache : public QOpenGLSharedResource
+// The color tables of all gradients are rows of a single texture, so that
+// fills with different gradients can be drawn with the same material and
+// end up in the same batch. Rows are reference counted by the nodes using
+// them. Unreferenced rows are kept for stops that come back until the rows
+// exceed the byte budget, after that the least recently used one is taken
+// for new stops instead of adding a row. The texture is reallocated with
+// more rows when it is full. A texture cannot be taller than
+// GL_MAX_TEXTURE_SIZE, rows past that go to further textures, the pages,
+// and only fills on the same page are batched.
+class QQUICKPATH_EXPORT QQuickPathGradientCache : public QOpenGLSharedResource
 {
 public:
-    QQuickPathGradientCache(QOpenGLContext *context)
-        : QOpenGLSharedResource(context->shareGroup())
-    {
-    }
-    ~QQuickPathGradientCache();
+    QQuickPathGradientCache(QOpenGLContext *context);
 
     void invalidateResource() override;
-    void freeResource(QOpenGLContext *) override;
-
-    QSGTexture *get(const QQuickPathRenderer::GradientDesc &grad);
+    void freeResource(QOpenGLContext *context) override;
+
+    enum { RowWidth = QQuickPathRenderer::GradientTableWidth };
+
+    // Returns the row with the given color table, copying the texels if it
+    // is not there yet. Every call must be paired with a releaseRow().
+    int acquireRow(const QQuickPathRenderer::GradientTable &table);
+    void releaseRow(int row);
+
+    // The page of a row returned by acquireRow() and the row within the
+    // page's texture.
+    int pageOf(int row) const { return row / m_pageRows; }
+    int rowInPage(int row) const { return row % m_pageRows; }
+
+    // Uploads the page's rows generated since the last call and binds its
+    // texture.
+    void bind(int page = 0);
+    // the height of the page's texture, valid after bind()
+    int textureRows(int page = 0) const;
+
+    // The budget for the rows, referenced or not. Defaults to
+    // QT_QUICKPATH_GRADIENT_CACHE_SIZE (in kilobytes) or 256 KB. Rows that
+    // are in use are never evicted, the cache grows beyond it if needed.
+    int maxBytes() const;
+    void setMaxBytes(int bytes);
+    int totalBytes() const;
+
+    // acquireRow() calls that found the table, that added it, and
+    // that had to evict an unreferenced one for it
+    int hits() const;
+    int misses() const;
+    int evictions() const;
+    void resetCounters();
+
+    // the cache shared by the context's share group
+    static QQuickPathGradientCache *cacheForContext(QOpenGLContext *context);
+    static QQuickPathGradientCache *currentCache();
 
 private:
-    QHash<QQuickPathRenderer::GradientDesc, QSGPlainTexture *> m_cache;
+    struct Row {
+        QGradientStops stops;
+        quint64 hash;
+        int ref;
+        // neighbours in the list of unreferenced rows
+        int lruPrev;
+        int lruNext;
+    };
+    struct Page {
+        GLuint texture;
+        int textureRows;
+        // rows to upload, within the page
+        int dirtyFirst;
+        int dirtyLast;
+    };
+    void linkUnused(int row);
+    void unlinkUnused(int row);
+    Page &pageForRow(int row);
+
+    mutable QMutex m_mutex;
+    QVector<Row> m_rows;
+    // rows by the hash of their tables
+    QMultiHash<quint64, int> m_index;
+    // the unreferenced rows, least recently used first
+    int m_lruFirst;
+    int m_lruLast;
+    // RowWidth texels for each row
+    QVector<uint> m_texels;
+    QVector<Page> m_pages;
+    // the most rows a texture can have
+    int m_pageRows;
+    int m_maxBytes;
+    int m_hits;
+    int m_misses;
+    int m_evictions;
 };
 
 class QQuickPathLinearGradientShader : public QSGMaterialShader
@@ -92,16 +165,14 @@ public:
 private:
     int m_opacityLoc;
     int m_matrixLoc;
-    int m_viewportSizeLoc;
-    int m_gradStartLoc;
-    int m_gradEndLoc;
+    int m_textureRowsLoc;
 };
 
 class QQuickPathLinearGradientMaterial : public QSGMaterial
 {
 public:
-    QQuickPathLinearGradientMaterial(QQuickPathRenderNode *node)
-        : m_node(node)
+    QQuickPathLinearGradientMaterial()
+        : m_page(0)
     {
         setFlag(Blending);
     }
@@ -118,10 +189,12 @@ public:
         return new QQuickPathLinearGradientShader;
     }
 
-    QQuickPathRenderNode *node() const { return m_node; }
+    // the gradient cache's page with the node's color table
+    int page() const { return m_page; }
+    void setPage(int page) { m_page = page; }
 
 private:
-    QQuickPathRenderNode *m_node;
+    int m_page;
 };
 
 #endif // QT_NO_OPENGL
@@ -37,8 +37,13 @@
 #include "qquickpathitem_p_p.h"
 #include "qnvprrendernode_p.h"
 #include "qquickpathrendernode_p.h"
+#include "qquickpathsoftwarerenderer_p.h"
+#include "qquickpathstencilrenderer_p.h"
+#include "qquickpathsvgparser_p.h"
 #include <QSGRendererInterface>
+#include <QQuickWindow>
 #include <QPainterPath>
+#include <qmath.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -46,6 +51,11 @@ QQuickPathItem::QQuickPathItem(QQuickItem *parent)
     : QQuickItem(*new QQuickPathItemPrivate, parent)
 {
     setFlag(ItemHasContents);
+    connect(this, &QQuickItem::antialiasingChanged, this, [this]() {
+        Q_D(QQuickPathItem);
+        d->dirty |= QQuickPathItemPrivate::DirtyFlags;
+        polish();
+    });
 }
 
 QQuickPathItem::~QQuickPathItem()
@@ -62,16 +72,145 @@ void QQuickPathItemPrivate::appendCommand(QQmlListProperty<QObject> *list, QObje
     QQuickPathItem *item = qobject_cast<QQuickPathItem *>(list->object);
     Q_ASSERT(item);
     ccmd->setParent(item);
-    QQuickPathItemPrivate::get(item)->commands.append(ccmd);
+    QQuickPathItemPrivate *d = QQuickPathItemPrivate::get(item);
+    d->commands.append(ccmd);
+    d->commandElementEnds.clear();
 }
 
-void QQuickPathItemPrivate::handlePathCommandChange()
+void QQuickPathItemPrivate::handlePathCommandChange(QQuickPathCommand *cmd)
 {
     Q_Q(QQuickPathItem);
+    const int index = commands.indexOf(cmd);
+    if (index < 0)
+        commandElementEnds.clear();
+    else if (firstDirtyCommand < 0 || index < firstDirtyCommand)
+        firstDirtyCommand = index;
+    lastDirtyCommand = qMax(lastDirtyCommand, index);
     dirty |= QQuickPathItemPrivate::DirtyPath;
     q->updatePath();
 }
 
+void QQuickPathItemPrivate::markPathModified(const QString &data)
+{
+    Q_Q(QQuickPathItem);
+    // the element ends no longer describe path, the next update from the
+    // commands rebuilds it
+    commandElementEnds.clear();
+    dirty |= QQuickPathItemPrivate::DirtyPath;
+    // pathData only reports the path while it is the one set from it
+    if (pathData != data) {
+        pathData = data;
+        emit q->pathDataChanged();
+    }
+}
+
+void QQuickPathItemPrivate::buildPathFromCommands()
+{
+    const Qt::FillRule fillRule = path.fillRule();
+    path = QPainterPath();
+    path.setFillRule(fillRule);
+    commandElementEnds.resize(commands.count());
+    for (int i = 0; i < commands.count(); ++i) {
+        commands[i]->addToPath(&path);
+        commandElementEnds[i] = path.elementCount();
+    }
+}
+
+// Runs the dirty commands again, on a scratch path that is set up to continue
+// where the previous command left off, and writes the element positions back
+// into path. The commands after the dirty ones are run as well until their
+// output stops changing, since e.g. quadTo() and closeSubpath() depend on the
+// elements before them. Returns false when the element types or their count
+// changed, path needs a full rebuild then. Otherwise firstElement and
+// lastElement are set to the range of elements that got new positions.
+bool QQuickPathItemPrivate::updatePathFromCommands(int *firstElement, int *lastElement)
+{
+    if (firstDirtyCommand < 0 || commandElementEnds.count() != commands.count()
+            || path.elementCount() != commandElementEnds.last())
+        return false;
+
+    const int start = firstDirtyCommand > 0 ? commandElementEnds.at(firstDirtyCommand - 1) : 0;
+    QPainterPath scratch;
+    if (start > 0) {
+        // The scratch path gets the same subpath start, current position and
+        // kind of last element as path has at start.
+        int subpathStart = start - 1;
+        while (subpathStart > 0 && !path.elementAt(subpathStart).isMoveTo())
+            --subpathStart;
+        const QPointF first = path.elementAt(subpathStart);
+        const QPainterPath::Element &last(path.elementAt(start - 1));
+        scratch.moveTo(first);
+        if (!last.isMoveTo()) {
+            // a point other than first and last, so that both lineTo()s add an element
+            QPointF other = first + QPointF(1, 1);
+            if (other == QPointF(last))
+                other += QPointF(1, 1);
+            scratch.lineTo(other);
+            scratch.lineTo(last);
+        }
+        if (qobject_cast<QQuickPathClose *>(commands.at(firstDirtyCommand - 1)))
+            scratch.closeSubpath();
+    }
+    // maps the scratch path's element indices to the ones in path
+    const int offset = start - scratch.elementCount();
+    const int prefixCount = scratch.elementCount();
+
+    for (int i = firstDirtyCommand; i < commands.count(); ++i) {
+        const int begin = scratch.elementCount();
+        commands.at(i)->addToPath(&scratch);
+        if (scratch.elementCount() + offset != commandElementEnds.at(i))
+            return false;
+        bool same = true;
+        for (int j = qMax(0, begin - 1); j < scratch.elementCount(); ++j) {
+            const QPainterPath::Element &e(scratch.elementAt(j));
+            const QPainterPath::Element &old(path.elementAt(j + offset));
+            if (j >= prefixCount && e.type != old.type)
+                return false;
+            same = same && e.x == old.x && e.y == old.y;
+        }
+        // Once a command past the dirty ones produces the same elements, the
+        // rest of the path is up to date, unless the subpath start moved or
+        // the next command could merge its moveTo() into this one's.
+        const int lastIndex = scratch.elementCount() - 1;
+        if (same && i >= lastDirtyCommand && lastIndex >= 0 && !scratch.elementAt(lastIndex).isMoveTo()) {
+            int subpathStart = lastIndex;
+            while (subpathStart > 0 && !scratch.elementAt(subpathStart).isMoveTo())
+                --subpathStart;
+            // the prefix's first elements do not correspond to anything in path
+            if (subpathStart < prefixCount - 1)
+                break;
+            const QPainterPath::Element &e(scratch.elementAt(subpathStart));
+            const QPainterPath::Element &old(path.elementAt(subpathStart + offset));
+            if (e.x == old.x && e.y == old.y)
+                break;
+        }
+    }
+
+    *firstElement = -1;
+    *lastElement = -1;
+    for (int j = qMax(0, prefixCount - 1); j < scratch.elementCount(); ++j) {
+        const QPainterPath::Element &e(scratch.elementAt(j));
+        const QPainterPath::Element &old(path.elementAt(j + offset));
+        if (e.x == old.x && e.y == old.y)
+            continue;
+        path.setElementPositionAt(j + offset, e.x, e.y);
+        if (*firstElement < 0)
+            *firstElement = j + offset;
+        *lastElement = j + offset;
+    }
+    return true;
+}
+
+#ifndef QT_NO_OPENGL
+// QT_QUICKPATH_STENCIL_THEN_COVER=1 makes OpenGL use stencil-then-cover
+// instead of triangulating the fill on the CPU.
+static bool useStencilThenCover()
+{
+    static const bool enabled = qEnvironmentVariableIntValue("QT_QUICKPATH_STENCIL_THEN_COVER");
+    return enabled;
+}
+#endif
+
 // renderer lives on the gui thread and all its functions except
 // updatePathRenderNode() are invoked on the gui thread.
 void QQuickPathItemPrivate::createRenderer()
@@ -84,13 +223,22 @@ void QQuickPathItemPrivate::createRenderer()
     switch (ri->graphicsApi()) {
 #ifndef QT_NO_OPENGL
     case QSGRendererInterface::OpenGL:
-        renderer = new QQuickPathRenderer(q);
+        if (useStencilThenCover())
+            renderer = new QQuickPathStencilRenderer(q);
+        else
+            renderer = new QQuickPathRenderer(q);
         break;
 #endif
+    case QSGRendererInterface::Software:
+        renderer = new QQuickPathSoftwareRenderer;
+        break;
     default:
         qWarning("No path backend for this graphics API yet");
         break;
     }
+
+    if (renderer)
+        renderer->setAsyncCallback(&QQuickPathItemPrivate::asyncGeometryReady, this);
 }
 
 // the node lives on the render thread
@@ -110,10 +258,25 @@ QSGNode *QQuickPathItemPrivate::createRenderNode()
     switch (ri->graphicsApi()) {
 #ifndef QT_NO_OPENGL
     case QSGRendererInterface::OpenGL:
-        node = new QQuickPathRootRenderNode(q->window(), hasFill, hasStroke);
-        static_cast<QQuickPathRenderer *>(renderer)->setRootNode(static_cast<QQuickPathRootRenderNode *>(node));
+        if (useStencilThenCover()) {
+            node = new QQuickPathStencilRenderNode(q);
+            static_cast<QQuickPathStencilRenderer *>(renderer)->setNode(static_cast<QQuickPathStencilRenderNode *>(node));
+        } else {
+            QQuickPathRenderer *r = static_cast<QQuickPathRenderer *>(renderer);
+            node = new QQuickPathRootRenderNode(q->window(), hasFill, hasStroke);
+            r->setRootNode(static_cast<QQuickPathRootRenderNode *>(node));
+            // the geometry uploaded to the previous nodes may not be around anymore
+            if (r->hasReleasedGeometry()) {
+                dirty |= QQuickPathItemPrivate::DirtyPath;
+                QMetaObject::invokeMethod(q, "updatePath", Qt::QueuedConnection);
+            }
+        }
         break;
 #endif
+    case QSGRendererInterface::Software:
+        node = new QQuickPathSoftwareRenderNode(q);
+        static_cast<QQuickPathSoftwareRenderer *>(renderer)->setNode(static_cast<QQuickPathSoftwareRenderNode *>(node));
+        break;
     default:
         qWarning("No path backend for this graphics API yet");
         break;
@@ -124,15 +287,38 @@ QSGNode *QQuickPathItemPrivate::createRenderNode()
 
 void QQuickPathItemPrivate::sync()
 {
+    Q_Q(QQuickPathItem);
     renderer->beginSync();
 
     if (dirty & QQuickPathItemPrivate::DirtyPath) {
+        QVector<QQuickPathPrimitive> primitives;
+        // Changing command properties usually only moves elements around,
+        // those get updated in place and the renderer is told which ones.
+        int firstElement = -1;
+        int lastElement = -1;
+        bool updated = false;
         if (!commands.isEmpty()) {
-            path = QPainterPath();
-            for (QQuickPathCommand *cmd : qAsConst(commands))
-                cmd->addToPath(&path);
+            updated = updatePathFromCommands(&firstElement, &lastElement);
+            if (!updated)
+                buildPathFromCommands();
+            for (QQuickPathCommand *cmd : qAsConst(commands)) {
+                QQuickPathPrimitive primitive;
+                if (!cmd->toPrimitive(&primitive)) {
+                    primitives.clear();
+                    break;
+                }
+                primitives.append(primitive);
+            }
         }
-        renderer->setPath(path);
+        firstDirtyCommand = -1;
+        lastDirtyCommand = -1;
+        if (updated)
+            renderer->updatePath(path, firstElement, lastElement);
+        else
+            renderer->setPath(path);
+        renderer->setPrimitives(primitives);
+    } else if (dirty & QQuickPathItemPrivate::DirtyFillRule) {
+        renderer->setFillRule(path.fillRule());
     }
     if (dirty & QQuickPathItemPrivate::DirtyFillColor)
         renderer->setFillColor(fillColor, fillGradient);
@@ -140,18 +326,78 @@ void QQuickPathItemPrivate::sync()
         renderer->setStrokeColor(strokeColor);
     if (dirty & QQuickPathItemPrivate::DirtyStrokeWidth)
         renderer->setStrokeWidth(strokeWidth);
-    if (dirty & QQuickPathItemPrivate::DirtyFlags)
-        renderer->setFlags(flags);
-    if (dirty & QQuickPathItemPrivate::DirtyStyle) {
+    if (dirty & QQuickPathItemPrivate::DirtyFlags) {
+        QQuickAbstractPathRenderer::RenderFlags f = flags;
+        f.setFlag(QQuickAbstractPathRenderer::RenderAntialiased, q->antialiasing());
+        renderer->setFlags(f);
+    }
+    if (dirty & QQuickPathItemPrivate::DirtyStrokeStyle) {
         renderer->setJoinStyle(joinStyle, miterLimit);
         renderer->setCapStyle(capStyle);
         renderer->setStrokeStyle(strokeStyle, dashOffset, dashPattern, cosmeticStroke);
     }
-
-    renderer->endSync();
+    if (dirty & QQuickPathItemPrivate::DirtyScale)
+        renderer->setScale(lodScale);
+    if (dirty & QQuickPathItemPrivate::DirtyStrokeTrim)
+        renderer->setStrokeTrim(strokeStart, strokeEnd);
+    if (dirty & QQuickPathItemPrivate::DirtyColorMode)
+        renderer->setColorMode(colorMode);
+
+    const bool useAsync = async && renderer->capabilities().testFlag(QQuickAbstractPathRenderer::SupportsAsync);
+    renderer->endSync(useAsync);
     dirty = 0;
 }
 
+// Geometry is generated for power of two scales and is regenerated only when
+// the actual scale leaves [lodScale * LOD_SCALE_MIN, lodScale * LOD_SCALE_MAX].
+// Zooming in makes curves look faceted soon, zooming out only means drawing
+// more vertices than necessary for a while.
+static const qreal LOD_SCALE_MIN = 0.25;
+static const qreal LOD_SCALE_MAX = 1.25;
+
+// Returns true when lodScale has changed.
+bool QQuickPathItemPrivate::updateLodScale()
+{
+    Q_Q(QQuickPathItem);
+    const QTransform t = itemToWindowTransform();
+    qreal scale = qMax(qSqrt(t.m11() * t.m11() + t.m12() * t.m12()),
+                       qSqrt(t.m21() * t.m21() + t.m22() * t.m22()));
+    if (q->window())
+        scale *= q->window()->effectiveDevicePixelRatio();
+
+    // nothing to see when scaled down to 0, keep the current geometry
+    if (qFuzzyIsNull(scale))
+        return false;
+    if (scale >= lodScale * LOD_SCALE_MIN && scale <= lodScale * LOD_SCALE_MAX)
+        return false;
+
+    lodScale = qPow(2, qCeil(qLn(scale) / M_LN2));
+    return true;
+}
+
+// Returns true when the scale of the item, or of any of its ancestors, has
+// changed since the last scene graph sync. Only the dirty flags are looked
+// at, so this is cheap enough to run every frame in static scenes.
+bool QQuickPathItemPrivate::hasDirtyTransform()
+{
+    const quint32 mask = Transform | BasicTransform | ParentChanged | Window;
+    for (QQuickItem *item = q_func(); item; item = item->parentItem()) {
+        if (QQuickItemPrivate::get(item)->dirtyAttributes & mask)
+            return true;
+    }
+    return false;
+}
+
+// invoked on the gui thread once the triangulation started by an asynchronous
+// sync() has finished
+void QQuickPathItemPrivate::asyncGeometryReady(void *data)
+{
+    QQuickPathItemPrivate *self = static_cast<QQuickPathItemPrivate *>(data);
+    QQuickPathItem *q = self->q_func();
+    q->update();
+    emit q->geometryReady();
+}
+
 void QQuickPathItem::updatePolish()
 {
     Q_D(QQuickPathItem);
@@ -165,6 +411,10 @@ void QQuickPathItem::updatePolish()
             return;
     }
 
+    if (d->renderer->capabilities().testFlag(QQuickAbstractPathRenderer::ScaleDependent)
+            && d->updateLodScale())
+        d->dirty |= QQuickPathItemPrivate::DirtyScale;
+
     // endSync() is where expensive calculations may happen, depending on the
     // backend. Therefore do this only when the item is visible.
     if (isVisible())
@@ -175,9 +425,36 @@ void QQuickPathItem::updatePolish()
 
 void QQuickPathItem::itemChange(ItemChange change, const ItemChangeData &data)
 {
+    Q_D(QQuickPathItem);
+
     if (change == ItemVisibleHasChanged && data.boolValue)
         updatePath();
 
+    // The item's transform, or the transform of any of its ancestors, may
+    // change without the item getting notified, e.g. in a pinch-zoom. Check
+    // once per frame if the geometry needs to be regenerated. The dirty flags
+    // are still set at afterAnimating, the scene graph clears them in sync.
+    if (change == ItemSceneChange) {
+        disconnect(d->afterAnimatingConnection);
+        if (data.window) {
+            d->afterAnimatingConnection = connect(data.window, &QQuickWindow::afterAnimating, this, [this]() {
+                Q_D(QQuickPathItem);
+                if (!d->renderer || !isVisible())
+                    return;
+                if (d->renderer->capabilities().testFlag(QQuickAbstractPathRenderer::ScaleDependent)
+                        && d->hasDirtyTransform() && d->updateLodScale()) {
+                    d->dirty |= QQuickPathItemPrivate::DirtyScale;
+                    polish();
+                }
+                // e.g. AutomaticColor going back to vertex colors
+                if (d->renderer->advanceFrame()) {
+                    d->dirty |= QQuickPathItemPrivate::DirtyColorMode;
+                    polish();
+                }
+            });
+        }
+    }
+
     QQuickItem::itemChange(change, data);
 }
 
@@ -205,7 +482,7 @@ void QQuickPathItem::clear()
 {
     Q_D(QQuickPathItem);
     d->path = QPainterPath();
-    d->dirty |= QQuickPathItemPrivate::DirtyPath;
+    d->markPathModified();
 }
 
 bool QQuickPathItem::isEmpty() const
@@ -218,77 +495,182 @@ void QQuickPathItem::closeSubPath()
 {
     Q_D(QQuickPathItem);
     d->path.closeSubpath();
-    d->dirty |= QQuickPathItemPrivate::DirtyPath;
+    d->markPathModified();
 }
 
 void QQuickPathItem::moveTo(qreal x, qreal y)
 {
     Q_D(QQuickPathItem);
     d->path.moveTo(x, y);
-    d->dirty |= QQuickPathItemPrivate::DirtyPath;
+    d->markPathModified();
 }
 
 void QQuickPathItem::lineTo(qreal x, qreal y)
 {
     Q_D(QQuickPathItem);
     d->path.lineTo(x, y);
-    d->dirty |= QQuickPathItemPrivate::DirtyPath;
+    d->markPathModified();
 }
 
 void QQuickPathItem::arcMoveTo(qreal x, qreal y, qreal w, qreal h, qreal angle)
 {
     Q_D(QQuickPathItem);
     d->path.arcMoveTo(x, y, w, h, angle);
-    d->dirty |= QQuickPathItemPrivate::DirtyPath;
+    d->markPathModified();
 }
 
 void QQuickPathItem::arcTo(qreal x, qreal y, qreal w, qreal h, qreal startAngle, qreal arcLength)
 {
     Q_D(QQuickPathItem);
     d->path.arcTo(x, y, w, h, startAngle, arcLength);
-    d->dirty |= QQuickPathItemPrivate::DirtyPath;
+    d->markPathModified();
 }
 
 void QQuickPathItem::cubicTo(qreal cx1, qreal cy1, qreal cx2, qreal cy2, qreal ex, qreal ey)
 {
     Q_D(QQuickPathItem);
     d->path.cubicTo(cx1, cy1, cx2, cy2, ex, ey);
-    d->dirty |= QQuickPathItemPrivate::DirtyPath;
+    d->markPathModified();
 }
 
 void QQuickPathItem::quadTo(qreal cx, qreal cy, qreal ex, qreal ey)
 {
     Q_D(QQuickPathItem);
     d->path.quadTo(cx, cy, ex, ey);
-    d->dirty |= QQuickPathItemPrivate::DirtyPath;
+    d->markPathModified();
 }
 
 void QQuickPathItem::addRect(qreal x, qreal y, qreal w, qreal h)
 {
     Q_D(QQuickPathItem);
     d->path.addRect(x, y, w, h);
-    d->dirty |= QQuickPathItemPrivate::DirtyPath;
+    d->markPathModified();
 }
 
 void QQuickPathItem::addRoundedRect(qreal x, qreal y, qreal w, qreal h, qreal xr, qreal yr)
 {
     Q_D(QQuickPathItem);
     d->path.addRoundedRect(x, y, w, h, xr, yr);
-    d->dirty |= QQuickPathItemPrivate::DirtyPath;
+    d->markPathModified();
 }
 
 void QQuickPathItem::addEllipse(qreal x, qreal y, qreal w, qreal h)
 {
     Q_D(QQuickPathItem);
     d->path.addEllipse(x, y, w, h);
-    d->dirty |= QQuickPathItemPrivate::DirtyPath;
+    d->markPathModified();
 }
 
 void QQuickPathItem::addEllipseWithCenter(qreal cx, qreal cy, qreal rx, qreal ry)
 {
     Q_D(QQuickPathItem);
     d->path.addEllipse(QPointF(cx, cy), rx, ry);
-    d->dirty |= QQuickPathItemPrivate::DirtyPath;
+    d->markPathModified();
+}
+
+// ArrayBuffers and typed arrays with the expected element type, bytes for
+// the commands and Float32Array for the coordinates, are taken over as they
+// are. Other typed arrays and plain arrays are converted element by element.
+static QByteArray jsArrayData(const QJSValue &value, bool floats)
+{
+    const QJSValue buffer = value.property(QStringLiteral("buffer"));
+    const bool typedArray = !buffer.isUndefined();
+    if (typedArray) {
+        const bool raw = floats
+                ? value.property(QStringLiteral("constructor")).property(QStringLiteral("name")).toString()
+                        == QLatin1String("Float32Array")
+                : value.property(QStringLiteral("BYTES_PER_ELEMENT")).toInt() == 1;
+        if (raw) {
+            // the temporary QVariant is gone by now, cutting out the view
+            // happens in place instead of copying it with mid()
+            QByteArray data = buffer.toVariant().toByteArray();
+            const int offset = value.property(QStringLiteral("byteOffset")).toInt();
+            const int length = value.property(QStringLiteral("byteLength")).toInt();
+            if (offset >= 0 && length >= 0 && offset <= data.size() - length) {
+                data.truncate(offset + length);
+                data.remove(0, offset);
+                return data;
+            }
+        }
+    }
+
+    if (typedArray || value.isArray()) {
+        const int length = value.property(QStringLiteral("length")).toInt();
+        QByteArray data(length * (floats ? int(sizeof(float)) : 1), Qt::Uninitialized);
+        for (int i = 0; i < length; ++i) {
+            if (floats)
+                reinterpret_cast<float *>(data.data())[i] = value.property(i).toNumber();
+            else
+                data[i] = char(value.property(i).toInt());
+        }
+        return data;
+    }
+
+    const QVariant data = value.toVariant();
+    if (data.type() == QVariant::ByteArray)
+        return data.toByteArray();
+
+    qWarning("PathItem: path data must be an ArrayBuffer, a typed array or an array");
+    return QByteArray();
+}
+
+// Replaces the path in one go, without a call per element. commands is a
+// Uint8Array of PathCommand values, coords a Float32Array with the
+// coordinates the commands use, in order. Those are the fastest, other
+// arrays of numbers work as well.
+void QQuickPathItem::setPathData(const QJSValue &commands, const QJSValue &coords)
+{
+    setPathData(jsArrayData(commands, false), jsArrayData(coords, true));
+}
+
+// coords holds floats in native byte order, as in a Float32Array.
+void QQuickPathItem::setPathData(const QByteArray &commands, const QByteArray &coords)
+{
+    setPathData(reinterpret_cast<const quint8 *>(commands.constData()), commands.size(),
+                reinterpret_cast<const float *>(coords.constData()), coords.size() / int(sizeof(float)));
+}
+
+void QQuickPathItem::setPathData(const quint8 *commands, int commandCount, const float *coords, int coordCount)
+{
+    Q_D(QQuickPathItem);
+    static const int coordsPerCommand[] = { 2, 2, 4, 6, 0 };
+
+    QPainterPath path;
+    path.setFillRule(d->path.fillRule());
+    const float *c = coords;
+    const float *end = coords + coordCount;
+    for (int i = 0; i < commandCount; ++i) {
+        if (commands[i] > CloseCommand) {
+            qWarning("PathItem: invalid path command %d", commands[i]);
+            return;
+        }
+        if (end - c < coordsPerCommand[commands[i]]) {
+            qWarning("PathItem: not enough coordinates for the path commands");
+            return;
+        }
+        switch (commands[i]) {
+        case MoveToCommand:
+            path.moveTo(c[0], c[1]);
+            break;
+        case LineToCommand:
+            path.lineTo(c[0], c[1]);
+            break;
+        case QuadToCommand:
+            path.quadTo(c[0], c[1], c[2], c[3]);
+            break;
+        case CubicToCommand:
+            path.cubicTo(c[0], c[1], c[2], c[3], c[4], c[5]);
+            break;
+        default:
+            path.closeSubpath();
+            break;
+        }
+        c += coordsPerCommand[commands[i]];
+    }
+
+    d->path = path;
+    d->markPathModified();
+    updatePath();
 }
 
 QPointF QQuickPathItem::currentPosition() const
@@ -320,7 +702,8 @@ void QQuickPathItem::setFillRule(FillRule fillRule)
     Q_D(QQuickPathItem);
     if (d->path.fillRule() != Qt::FillRule(fillRule)) {
         d->path.setFillRule(Qt::FillRule(fillRule));
-        d->dirty |= QQuickPathItemPrivate::DirtyPath;
+        // the renderers can usually switch without processing the path again
+        d->dirty |= QQuickPathItemPrivate::DirtyFillRule;
         emit fillRuleChanged();
         updatePath();
     }
@@ -413,7 +796,7 @@ void QQuickPathItem::setJoinStyle(JoinStyle style)
     Q_D(QQuickPathItem);
     if (d->joinStyle != style) {
         d->joinStyle = style;
-        d->dirty |= QQuickPathItemPrivate::DirtyStyle;
+        d->dirty |= QQuickPathItemPrivate::DirtyStrokeStyle;
         emit joinStyleChanged();
         updatePath();
     }
@@ -430,7 +813,7 @@ void QQuickPathItem::setMiterLimit(int limit)
     Q_D(QQuickPathItem);
     if (d->miterLimit != limit) {
         d->miterLimit = limit;
-        d->dirty |= QQuickPathItemPrivate::DirtyStyle;
+        d->dirty |= QQuickPathItemPrivate::DirtyStrokeStyle;
         emit miterLimitChanged();
         updatePath();
     }
@@ -447,7 +830,7 @@ void QQuickPathItem::setCapStyle(CapStyle style)
     Q_D(QQuickPathItem);
     if (d->capStyle != style) {
         d->capStyle = style;
-        d->dirty |= QQuickPathItemPrivate::DirtyStyle;
+        d->dirty |= QQuickPathItemPrivate::DirtyStrokeStyle;
         emit capStyleChanged();
         updatePath();
     }
@@ -464,7 +847,7 @@ void QQuickPathItem::setStrokeStyle(StrokeStyle style)
     Q_D(QQuickPathItem);
     if (d->strokeStyle != style) {
         d->strokeStyle = style;
-        d->dirty |= QQuickPathItemPrivate::DirtyStyle;
+        d->dirty |= QQuickPathItemPrivate::DirtyStrokeStyle;
         emit strokeStyleChanged();
         updatePath();
     }
@@ -481,7 +864,7 @@ void QQuickPathItem::setDashOffset(qreal offset)
     Q_D(QQuickPathItem);
     if (d->dashOffset != offset) {
         d->dashOffset = offset;
-        d->dirty |= QQuickPathItemPrivate::DirtyStyle;
+        d->dirty |= QQuickPathItemPrivate::DirtyStrokeStyle;
         emit dashOffsetChanged();
         updatePath();
     }
@@ -498,7 +881,7 @@ void QQuickPathItem::setDashPattern(const QVector<qreal> &array)
     Q_D(QQuickPathItem);
     if (d->dashPattern != array) {
         d->dashPattern = array;
-        d->dirty |= QQuickPathItemPrivate::DirtyStyle;
+        d->dirty |= QQuickPathItemPrivate::DirtyStrokeStyle;
         emit dashPatternChanged();
         updatePath();
     }
@@ -515,12 +898,141 @@ void QQuickPathItem::setCosmeticStroke(bool cosmetic)
     Q_D(QQuickPathItem);
     if (d->cosmeticStroke != cosmetic) {
         d->cosmeticStroke = cosmetic;
-        d->dirty |= QQuickPathItemPrivate::DirtyStyle;
+        d->dirty |= QQuickPathItemPrivate::DirtyStrokeStyle;
         emit cosmeticStrokeChanged();
         updatePath();
     }
 }
 
+qreal QQuickPathItem::strokeStart() const
+{
+    Q_D(const QQuickPathItem);
+    return d->strokeStart;
+}
+
+// The stroke covers the part of the path between strokeStart and strokeEnd,
+// both in the range 0..1 of the total length of the path. The trimmed ends
+// are flat. With the OpenGL backend changing these does not need new
+// geometry for strokes that are not cosmetic.
+void QQuickPathItem::setStrokeStart(qreal start)
+{
+    Q_D(QQuickPathItem);
+    start = qBound<qreal>(0, start, 1);
+    if (d->strokeStart != start) {
+        d->strokeStart = start;
+        d->dirty |= QQuickPathItemPrivate::DirtyStrokeTrim;
+        emit strokeStartChanged();
+        updatePath();
+    }
+}
+
+qreal QQuickPathItem::strokeEnd() const
+{
+    Q_D(const QQuickPathItem);
+    return d->strokeEnd;
+}
+
+void QQuickPathItem::setStrokeEnd(qreal end)
+{
+    Q_D(QQuickPathItem);
+    end = qBound<qreal>(0, end, 1);
+    if (d->strokeEnd != end) {
+        d->strokeEnd = end;
+        d->dirty |= QQuickPathItemPrivate::DirtyStrokeTrim;
+        emit strokeEndChanged();
+        updatePath();
+    }
+}
+
+bool QQuickPathItem::asynchronous() const
+{
+    Q_D(const QQuickPathItem);
+    return d->async;
+}
+
+// When enabled, the potentially expensive triangulation of the fill and
+// stroke happens on worker threads instead of blocking the gui thread in
+// updatePolish(). The new geometry is picked up by a later frame,
+// geometryReady() is emitted when that becomes available.
+void QQuickPathItem::setAsynchronous(bool async)
+{
+    Q_D(QQuickPathItem);
+    if (d->async != async) {
+        d->async = async;
+        emit asynchronousChanged();
+    }
+}
+
+bool QQuickPathItem::curveRendering() const
+{
+    Q_D(const QQuickPathItem);
+    return d->flags.testFlag(QQuickAbstractPathRenderer::RenderCurves);
+}
+
+// When enabled, curved segments of the fill are not flattened but drawn as
+// one triangle each, with the curve evaluated in the fragment shader. This
+// needs far fewer vertices and keeps quadratic curves exact at any scale.
+// Only solid fills are affected, and only with the OpenGL backend.
+void QQuickPathItem::setCurveRendering(bool enabled)
+{
+    Q_D(QQuickPathItem);
+    if (curveRendering() != enabled) {
+        d->flags.setFlag(QQuickAbstractPathRenderer::RenderCurves, enabled);
+        d->dirty |= QQuickPathItemPrivate::DirtyFlags;
+        emit curveRenderingChanged();
+        updatePath();
+    }
+}
+
+QString QQuickPathItem::pathData() const
+{
+    Q_D(const QQuickPathItem);
+    return d->pathData;
+}
+
+// Replaces the path with the one given in SVG path data syntax, like the
+// d attribute of an SVG <path>. Later calls to moveTo() etc. continue it,
+// pathData is empty from then on.
+void QQuickPathItem::setPathData(const QString &data)
+{
+    Q_D(QQuickPathItem);
+    if (d->pathData == data)
+        return;
+
+    QPainterPath path;
+    path.setFillRule(d->path.fillRule());
+    if (!QQuickPathSvgParser::parse(data, &path))
+        qWarning("PathItem: invalid path data, ignoring everything after the error");
+    d->path = path;
+    d->markPathModified(data);
+    updatePath();
+}
+
+QQuickPathItem::ColorMode QQuickPathItem::colorMode() const
+{
+    Q_D(const QQuickPathItem);
+    return d->colorMode;
+}
+
+// With VertexColor solid fills and strokes carry their color in every
+// vertex. Items with different colors can be batched together then, but
+// changing the color means rewriting and uploading all the vertices.
+// UniformColor passes the color to the shader instead and the vertices get
+// smaller. AutomaticColor, the default, uses vertex colors unless the color
+// keeps changing while the geometry does not, e.g. in a ColorAnimation.
+// Fills with a gradient or curveRendering, and strokes where the width is
+// applied in the shader, always use vertex colors.
+void QQuickPathItem::setColorMode(ColorMode mode)
+{
+    Q_D(QQuickPathItem);
+    if (d->colorMode != mode) {
+        d->colorMode = mode;
+        d->dirty |= QQuickPathItemPrivate::DirtyColorMode;
+        emit colorModeChanged();
+        updatePath();
+    }
+}
+
 QQmlListProperty<QObject> QQuickPathItem::commands()
 {
     return QQmlListProperty<QObject>(this, nullptr, &QQuickPathItemPrivate::appendCommand, nullptr, nullptr, nullptr);
@@ -50,6 +50,7 @@
 
 #include <QtQuickPath/qtquickpathglobal.h>
 #include <QQuickItem>
+#include <QJSValue>
 #include "qquickpathgradient_p.h"
 #include "qquickpathcommand_p.h"
 
@@ -73,6 +74,12 @@ class QQUICKPATH_EXPORT QQuickPathItem : public QQuickItem
     Q_PROPERTY(qreal dashOffset READ dashOffset WRITE setDashOffset NOTIFY dashOffsetChanged)
     Q_PROPERTY(QVector<qreal> dashPattern READ dashPattern WRITE setDashPattern NOTIFY dashPatternChanged)
     Q_PROPERTY(bool cosmeticStroke READ isCosmeticStroke WRITE setCosmeticStroke NOTIFY cosmeticStrokeChanged)
+    Q_PROPERTY(qreal strokeStart READ strokeStart WRITE setStrokeStart NOTIFY strokeStartChanged)
+    Q_PROPERTY(qreal strokeEnd READ strokeEnd WRITE setStrokeEnd NOTIFY strokeEndChanged)
+    Q_PROPERTY(bool asynchronous READ asynchronous WRITE setAsynchronous NOTIFY asynchronousChanged)
+    Q_PROPERTY(bool curveRendering READ curveRendering WRITE setCurveRendering NOTIFY curveRenderingChanged)
+    Q_PROPERTY(QString pathData READ pathData WRITE setPathData NOTIFY pathDataChanged)
+    Q_PROPERTY(ColorMode colorMode READ colorMode WRITE setColorMode NOTIFY colorModeChanged)
 
     Q_PROPERTY(QQmlListProperty<QObject> commands READ commands)
     Q_CLASSINFO("DefaultProperty", "commands")
@@ -104,6 +111,23 @@ public:
     };
     Q_ENUM(StrokeStyle)
 
+    enum ColorMode {
+        AutomaticColor,
+        VertexColor,
+        UniformColor
+    };
+    Q_ENUM(ColorMode)
+
+    // for setPathData(), each command consumes 2, 2, 4, 6 and 0 coordinates
+    enum PathCommand {
+        MoveToCommand,
+        LineToCommand,
+        QuadToCommand,
+        CubicToCommand,
+        CloseCommand
+    };
+    Q_ENUM(PathCommand)
+
     QQuickPathItem(QQuickItem *parent = nullptr);
     ~QQuickPathItem();
 
@@ -123,6 +147,10 @@ public:
     Q_INVOKABLE void addEllipse(qreal x, qreal y, qreal w, qreal h);
     Q_INVOKABLE void addEllipseWithCenter(qreal cx, qreal cy, qreal rx, qreal ry);
 
+    Q_INVOKABLE void setPathData(const QJSValue &commands, const QJSValue &coords);
+    void setPathData(const QByteArray &commands, const QByteArray &coords);
+    void setPathData(const quint8 *commands, int commandCount, const float *coords, int coordCount);
+
     Q_INVOKABLE QPointF currentPosition() const;
     Q_INVOKABLE QRectF boundingRect() const;
     Q_INVOKABLE QRectF controlPointRect() const;
@@ -164,6 +192,24 @@ public:
     bool isCosmeticStroke() const;
     void setCosmeticStroke(bool cosmetic);
 
+    qreal strokeStart() const;
+    void setStrokeStart(qreal start);
+
+    qreal strokeEnd() const;
+    void setStrokeEnd(qreal end);
+
+    bool asynchronous() const;
+    void setAsynchronous(bool async);
+
+    bool curveRendering() const;
+    void setCurveRendering(bool enabled);
+
+    QString pathData() const;
+    void setPathData(const QString &data);
+
+    ColorMode colorMode() const;
+    void setColorMode(ColorMode mode);
+
     QQmlListProperty<QObject> commands();
 
 public slots:
@@ -186,6 +232,13 @@ signals:
     void dashOffsetChanged();
     void dashPatternChanged();
     void cosmeticStrokeChanged();
+    void strokeStartChanged();
+    void strokeEndChanged();
+    void asynchronousChanged();
+    void curveRenderingChanged();
+    void pathDataChanged();
+    void colorModeChanged();
+    void geometryReady();
 
 private:
     Q_DISABLE_COPY(QQuickPathItem)
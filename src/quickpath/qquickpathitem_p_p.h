@@ -54,7 +54,7 @@
 
 QT_BEGIN_NAMESPACE
 
-class QQuickPathItemPrivate : public QQuickItemPrivate
+class Q_AUTOTEST_EXPORT QQuickPathItemPrivate : public QQuickItemPrivate
 {
     Q_DECLARE_PUBLIC(QQuickPathItem)
 
@@ -72,7 +72,14 @@ public:
           strokeStyle(QQuickPathItem::SolidLine),
           dashOffset(0),
           cosmeticStroke(false),
-          fillGradient(nullptr)
+          strokeStart(0),
+          strokeEnd(1),
+          async(false),
+          fillGradient(nullptr),
+          colorMode(QQuickPathItem::AutomaticColor),
+          firstDirtyCommand(-1),
+          lastDirtyCommand(-1),
+          lodScale(1)
     {
         dashPattern << 4 << 2; // 4 * strokeWidth dash followed by 2 * strokeWidth space
     }
@@ -80,10 +87,18 @@ public:
 
     static QQuickPathItemPrivate *get(QQuickPathItem *item) { return item->d_func(); }
     static void appendCommand(QQmlListProperty<QObject> *list, QObject *cmd);
-    void handlePathCommandChange();
+    void handlePathCommandChange(QQuickPathCommand *cmd);
+    // for changes to path that do not come from the commands, data is the
+    // SVG path data it was set from, if any
+    void markPathModified(const QString &data = QString());
+    void buildPathFromCommands();
+    bool updatePathFromCommands(int *firstElement, int *lastElement);
     void createRenderer();
     QSGNode *createRenderNode();
     void sync();
+    bool updateLodScale();
+    bool hasDirtyTransform();
+    static void asyncGeometryReady(void *data);
 
     enum Dirty {
         DirtyPath = 0x01,
@@ -91,9 +106,13 @@ public:
         DirtyStrokeColor = 0x04,
         DirtyStrokeWidth = 0x08,
         DirtyFlags = 0x10,
-        DirtyStyle = 0x20,
+        DirtyStrokeStyle = 0x20,
+        DirtyScale = 0x40,
+        DirtyStrokeTrim = 0x80,
+        DirtyFillRule = 0x100,
+        DirtyColorMode = 0x200,
 
-        DirtyAll = 0xFF
+        DirtyAll = 0x3FF
     };
 
     QPainterPath path;
@@ -110,8 +129,20 @@ public:
     qreal dashOffset;
     QVector<qreal> dashPattern;
     bool cosmeticStroke;
+    qreal strokeStart;
+    qreal strokeEnd;
+    bool async;
     QQuickPathGradient *fillGradient;
+    QString pathData;
+    QQuickPathItem::ColorMode colorMode;
     QVector<QQuickPathCommand *> commands;
+    // the commands whose properties changed since the last sync
+    int firstDirtyCommand;
+    int lastDirtyCommand;
+    // path's element count after each command, empty when it needs rebuilding
+    QVector<int> commandElementEnds;
+    qreal lodScale;
+    QMetaObject::Connection afterAnimatingConnection;
 };
 
 QT_END_NAMESPACE
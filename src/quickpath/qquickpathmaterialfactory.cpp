@@ -37,8 +37,12 @@
 #include "qquickpathmaterialfactory_p.h"
 #include "qquickpathrendernode_p.h"
 #include "qquickpathgradientmaterial_p.h"
+#include "qquickpathsmoothcolormaterial_p.h"
+#include "qquickpathcurvematerial_p.h"
+#include "qquickpathextrudedstrokematerial_p.h"
 #include <QQuickWindow>
 #include <QSGVertexColorMaterial>
+#include <QSGFlatColorMaterial>
 
 QT_BEGIN_NAMESPACE
 
@@ -56,14 +60,70 @@ QSGMaterial *QQuickPathMaterialFactory::createVertexColor(QQuickWindow *window)
     return nullptr;
 }
 
-QSGMaterial *QQuickPathMaterialFactory::createLinearGradient(QQuickWindow *window, QQuickPathRenderNode *node)
+QSGMaterial *QQuickPathMaterialFactory::createFlatColor(QQuickWindow *window)
 {
     QSGRendererInterface *rif = window->rendererInterface();
     QSGRendererInterface::GraphicsApi api = rif->graphicsApi();
 
 #ifndef QT_NO_OPENGL
     if (api == QSGRendererInterface::OpenGL)
-        return new QQuickPathLinearGradientMaterial(node);
+        return new QSGFlatColorMaterial;
+#endif
+
+    qWarning("Unsupported api %d", api);
+    return nullptr;
+}
+
+QSGMaterial *QQuickPathMaterialFactory::createLinearGradient(QQuickWindow *window)
+{
+    QSGRendererInterface *rif = window->rendererInterface();
+    QSGRendererInterface::GraphicsApi api = rif->graphicsApi();
+
+#ifndef QT_NO_OPENGL
+    if (api == QSGRendererInterface::OpenGL)
+        return new QQuickPathLinearGradientMaterial;
+#endif
+
+    qWarning("Unsupported api %d", api);
+    return nullptr;
+}
+
+QSGMaterial *QQuickPathMaterialFactory::createSmoothColor(QQuickWindow *window)
+{
+    QSGRendererInterface *rif = window->rendererInterface();
+    QSGRendererInterface::GraphicsApi api = rif->graphicsApi();
+
+#ifndef QT_NO_OPENGL
+    if (api == QSGRendererInterface::OpenGL)
+        return new QQuickPathSmoothColorMaterial;
+#endif
+
+    qWarning("Unsupported api %d", api);
+    return nullptr;
+}
+
+QSGMaterial *QQuickPathMaterialFactory::createCurve(QQuickWindow *window)
+{
+    QSGRendererInterface *rif = window->rendererInterface();
+    QSGRendererInterface::GraphicsApi api = rif->graphicsApi();
+
+#ifndef QT_NO_OPENGL
+    if (api == QSGRendererInterface::OpenGL)
+        return new QQuickPathCurveMaterial;
+#endif
+
+    qWarning("Unsupported api %d", api);
+    return nullptr;
+}
+
+QSGMaterial *QQuickPathMaterialFactory::createExtrudedStroke(QQuickWindow *window)
+{
+    QSGRendererInterface *rif = window->rendererInterface();
+    QSGRendererInterface::GraphicsApi api = rif->graphicsApi();
+
+#ifndef QT_NO_OPENGL
+    if (api == QSGRendererInterface::OpenGL)
+        return new QQuickPathExtrudedStrokeMaterial;
 #endif
 
     qWarning("Unsupported api %d", api);
@@ -53,13 +53,15 @@
 
 QT_BEGIN_NAMESPACE
 
-class QQuickPathRenderNode;
-
 class QQuickPathMaterialFactory
 {
 public:
     static QSGMaterial *createVertexColor(QQuickWindow *window);
-    static QSGMaterial *createLinearGradient(QQuickWindow *window, QQuickPathRenderNode *node);
+    static QSGMaterial *createFlatColor(QQuickWindow *window);
+    static QSGMaterial *createLinearGradient(QQuickWindow *window);
+    static QSGMaterial *createSmoothColor(QQuickWindow *window);
+    static QSGMaterial *createCurve(QQuickWindow *window);
+    static QSGMaterial *createExtrudedStroke(QQuickWindow *window);
 };
 
 QT_END_NAMESPACE
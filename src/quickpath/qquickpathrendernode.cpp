@@ -37,11 +37,56 @@
 #include "qquickpathrendernode_p.h"
 #include "qquickpathmaterialfactory_p.h"
 #include "qquickpathitem_p.h"
+#include "qquickpathtriangulationcache_p.h"
+#include "qquickpathextrudedstrokematerial_p.h"
+#include "qquickpathgradientmaterial_p.h"
+#include <QGuiApplication>
+#include <QQuickWindow>
+#include <QThreadPool>
+#include <QOpenGLContext>
+#include <QOffscreenSurface>
+#include <QSGFlatColorMaterial>
+#include <qmath.h>
+#include <algorithm>
+#include <climits>
 #include <QtGui/private/qtriangulator_p.h>
+#include <QtGui/private/qbezier_p.h>
+#include <QtGui/private/qopenglextensions_p.h>
+#include <QtGui/private/qdrawhelper_p.h>
+#include <QtCore/private/qsimd_p.h>
 
 QT_BEGIN_NAMESPACE
 
-static const qreal SCALE = 100;
+// Curves are flattened so that they stay within this many device pixels of
+// the real curve.
+static const qreal CURVE_TOLERANCE = 0.25;
+
+// qTriangulate() and QBezier flatten curves to within half a unit of the
+// space they work in. Returns the scale to that space, given the scale from
+// item coordinates to device pixels. The upper bound keeps the triangulator's
+// fixed point coordinates from overflowing.
+static inline qreal triangulationScale(qreal scale)
+{
+    return qBound(qreal(0.01), scale * 0.5 / CURVE_TOLERANCE, qreal(10000));
+}
+
+// the most vertices a mesh drawn with 16-bit indices can have
+static const int MAX_USHORT_VERTICES = 65536;
+
+// Triangulation in asynchronous mode happens on a dedicated pool so that
+// long-running jobs do not starve other users of the global instance. The
+// jobs are CPU bound, one core is left to the gui and render threads.
+class QQuickPathWorkerPool : public QThreadPool
+{
+public:
+    QQuickPathWorkerPool()
+    {
+        const int idealCount = QThread::idealThreadCount();
+        setMaxThreadCount(idealCount > 0 ? qMax(1, idealCount - 1) : 2);
+    }
+};
+
+Q_GLOBAL_STATIC(QQuickPathWorkerPool, qt_path_worker_pool)
 
 struct ColoredVertex // must match QSGGeometry::ColoredPoint2D
 {
@@ -94,18 +139,21 @@ QQuickPathRootRenderNode::~QQuickPathRootRenderNode()
 }
 
 QQuickPathRenderNode::QQuickPathRenderNode(QQuickWindow *window, QQuickPathRootRenderNode *rootNode)
-    : m_geometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0, 0),
+    : m_geometry(new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0, 0)),
       m_window(window),
       m_rootNode(rootNode),
-      m_dirty(0),
-      m_material(nullptr)
+      m_gradientRow(-1),
+      m_material(nullptr),
+      m_fringeNode(nullptr)
 {
-    setGeometry(&m_geometry);
+    setGeometry(m_geometry);
+    setFlag(OwnsGeometry, true);
     activateMaterial(MatSolidColor);
 }
 
 QQuickPathRenderNode::~QQuickPathRenderNode()
 {
+    releaseGradientRow();
 }
 
 void QQuickPathRenderNode::activateMaterial(Material m)
@@ -120,9 +168,26 @@ void QQuickPathRenderNode::activateMaterial(Material m)
         break;
     case MatLinearGradient:
         if (!m_linearGradientMaterial)
-            m_linearGradientMaterial.reset(QQuickPathMaterialFactory::createLinearGradient(m_window, this));
+            m_linearGradientMaterial.reset(QQuickPathMaterialFactory::createLinearGradient(m_window));
         m_material = m_linearGradientMaterial.data();
         break;
+    case MatCurve:
+        if (!m_curveMaterial)
+            m_curveMaterial.reset(QQuickPathMaterialFactory::createCurve(m_window));
+        m_material = m_curveMaterial.data();
+        break;
+    case MatExtrudedStroke:
+        if (!m_extrudedStrokeMaterial)
+            m_extrudedStrokeMaterial.reset(QQuickPathMaterialFactory::createExtrudedStroke(m_window));
+        m_material = m_extrudedStrokeMaterial.data();
+        break;
+    case MatFlatColor:
+        // The color is a uniform, so changing it does not touch the vertices,
+        // but nodes with different colors do not get batched.
+        if (!m_flatColorMaterial)
+            m_flatColorMaterial.reset(QQuickPathMaterialFactory::createFlatColor(m_window));
+        m_material = m_flatColorMaterial.data();
+        break;
     default:
         qWarning("Unknown material %d", m);
         return;
@@ -132,6 +197,96 @@ void QQuickPathRenderNode::activateMaterial(Material m)
         setMaterial(m_material);
 }
 
+QQuickPathFringeNode::QQuickPathFringeNode(QQuickWindow *window)
+    : m_material(QQuickPathMaterialFactory::createSmoothColor(window))
+{
+    QSGGeometry *g = new QSGGeometry(QQuickPathRenderer::smoothColoredAttributes(), 0);
+    g->setDrawingMode(QSGGeometry::DrawTriangleStrip);
+    setGeometry(g);
+    setFlag(OwnsGeometry, true);
+    setMaterial(m_material.data());
+}
+
+QSGGeometry *QQuickPathRenderNode::ensureGeometry(const QSGGeometry::AttributeSet &attrs, QSGGeometry::Type indexType)
+{
+    if (m_geometry->attributes() != attrs.attributes || m_geometry->indexType() != indexType) {
+        m_geometry = new QSGGeometry(attrs, 0, 0, indexType);
+        setGeometry(m_geometry); // deletes the old one
+    }
+    return m_geometry;
+}
+
+// Copies the positions from vertices of any of the formats, they all start
+// with x and y.
+static void copyPositions(QSGGeometry *g, const void *src, int srcStride)
+{
+    const char *vsrc = static_cast<const char *>(src);
+    char *vdst = static_cast<char *>(g->vertexData());
+    const int dstStride = g->sizeOfVertex();
+    for (int i = 0; i < g->vertexCount(); ++i, vsrc += srcStride, vdst += dstStride)
+        memcpy(vdst, vsrc, 2 * sizeof(float));
+}
+
+bool QQuickPathRenderNode::convertVertexFormat(const QSGGeometry::AttributeSet &attrs)
+{
+    if (m_geometry->attributes() == attrs.attributes)
+        return false;
+
+    QSGGeometry *g = new QSGGeometry(attrs, m_geometry->vertexCount(), m_geometry->indexCount(),
+                                     m_geometry->indexType());
+    g->setDrawingMode(m_geometry->drawingMode());
+    memset(g->vertexData(), 0, g->vertexCount() * g->sizeOfVertex());
+    copyPositions(g, m_geometry->vertexData(), m_geometry->sizeOfVertex());
+    memcpy(g->indexData(), m_geometry->indexData(), g->indexCount() * g->sizeOfIndex());
+    m_geometry = g;
+    setGeometry(m_geometry); // deletes the old one
+    return true;
+}
+
+int QQuickPathRenderNode::updateGradientRow(const QQuickPathRenderer::GradientTable &table)
+{
+#ifndef QT_NO_OPENGL
+    QOpenGLContext *context = m_window->openglContext();
+    if (!context)
+        return 0;
+    QQuickPathGradientCache *cache = QQuickPathGradientCache::cacheForContext(context);
+    // acquire first, an unchanged table keeps its row then
+    const int row = cache->acquireRow(table);
+    cache->releaseRow(m_gradientRow);
+    m_gradientRow = row;
+    // the material binds the page's texture, the vertices get the row in it
+    QQuickPathLinearGradientMaterial *m = static_cast<QQuickPathLinearGradientMaterial *>(m_linearGradientMaterial.data());
+    if (m && m->page() != cache->pageOf(row)) {
+        m->setPage(cache->pageOf(row));
+        markDirty(DirtyMaterial);
+    }
+    return cache->rowInPage(row);
+#else
+    Q_UNUSED(table);
+    return 0;
+#endif
+}
+
+void QQuickPathRenderNode::releaseGradientRow()
+{
+#ifndef QT_NO_OPENGL
+    if (m_gradientRow < 0)
+        return;
+    if (QOpenGLContext *context = m_window->openglContext())
+        QQuickPathGradientCache::cacheForContext(context)->releaseRow(m_gradientRow);
+    m_gradientRow = -1;
+#endif
+}
+
+QQuickPathRenderer::~QQuickPathRenderer()
+{
+    // jobs still in flight must not touch the renderer once they finish
+    if (m_pendingFill)
+        m_pendingFill->orphaned.store(1);
+    if (m_pendingStroke)
+        m_pendingStroke->orphaned.store(1);
+}
+
 void QQuickPathRenderer::setRootNode(QQuickPathRootRenderNode *rn)
 {
     m_rootNode = rn;
@@ -147,51 +302,146 @@ void QQuickPathRenderer::beginSync()
 void QQuickPathRenderer::setPath(const QPainterPath &path)
 {
     m_path = path;
-    m_guiDirty |= DirtyGeom;
+    m_piecesChangeFirst = -1;
+    m_guiDirty |= DirtyFillGeom | DirtyStrokeGeom;
+}
+
+void QQuickPathRenderer::updatePath(const QPainterPath &path, int firstElement, int lastElement)
+{
+    m_path = path;
+    // accumulates until the pieces get made from the current path
+    if (m_piecesChangeFirst >= 0 && firstElement >= 0) {
+        m_piecesChangeFirst = qMin(m_piecesChangeFirst, firstElement);
+        m_piecesChangeLast = qMax(m_piecesChangeLast, lastElement);
+    }
+    m_guiDirty |= DirtyFillGeom | DirtyStrokeGeom;
+}
+
+void QQuickPathRenderer::setFillRule(Qt::FillRule fillRule)
+{
+    if (m_path.fillRule() == fillRule)
+        return;
+    m_path.setFillRule(fillRule);
+    // Most items never change the rule, the other one only gets triangulated
+    // after the first change. The pieces and pending results made until then
+    // have nothing for it.
+    if (!m_fillRuleToggled) {
+        m_fillRuleToggled = true;
+        m_fillPieces.clear();
+        if (!m_otherFillValid || m_pendingFill) {
+            m_guiDirty |= DirtyFillGeom;
+            return;
+        }
+    }
+    // From then on both rules are triangulated together. Pending results get
+    // picked from when they arrive, finished ones only need to be swapped.
+    if ((m_guiDirty & DirtyFillGeom) || m_pendingFill)
+        return;
+    if (m_otherFillValid) {
+        qSwap(m_fill, m_otherFill);
+        m_guiDirty |= DirtyFillRule;
+    } else {
+        m_guiDirty |= DirtyFillGeom;
+    }
+}
+
+void QQuickPathRenderer::setPrimitives(const QVector<QQuickPathPrimitive> &primitives)
+{
+    m_primitives = primitives;
+}
+
+void QQuickPathRenderer::setScale(qreal scale)
+{
+    if (m_scale == scale)
+        return;
+    m_scale = scale;
+    m_fillPieces.clear();
+    m_guiDirty |= DirtyFillGeom | DirtyStrokeGeom;
+}
+
+void QQuickPathRenderer::setStrokeTrim(qreal start, qreal end)
+{
+    if (m_trimStart == start && m_trimEnd == end)
+        return;
+    m_trimStart = start;
+    m_trimEnd = end;
+    // extruded geometry covers the whole path, the shader does the trimming
+    if (m_strokeExtruded)
+        m_guiDirty |= DirtyStrokeTrim;
+    else
+        m_guiDirty |= DirtyStrokeGeom;
+}
+
+void QQuickPathRenderer::setColorMode(QQuickPathItem::ColorMode mode)
+{
+    m_colorMode = mode;
+    m_guiDirty |= DirtyColorMode;
 }
 
 void QQuickPathRenderer::setFillColor(const QColor &color, QQuickPathGradient *gradient)
 {
+    // Released geometry has to be generated again when the node gets
+    // recreated, or when the material and the fringe change.
+    if (m_fillReleased && (m_fillColor.a == 0 || m_fillGradientActive != (gradient != nullptr)))
+        m_guiDirty |= DirtyFillGeom;
     m_fillColor = colorToColor4ub(color);
+    // curves are only rendered for solid fills
+    if (m_flags.testFlag(RenderCurves) && m_fillGradientActive != (gradient != nullptr))
+        m_guiDirty |= DirtyFillGeom;
     m_fillGradientActive = gradient != nullptr;
     if (gradient) {
         m_fillGradient.stops = gradient->sortedGradientStops();
         m_fillGradient.start = QPointF(gradient->x1(), gradient->y1());
         m_fillGradient.end = QPointF(gradient->x2(), gradient->y2());
         m_fillGradient.spread = gradient->spread();
+        updateGradientTable(&m_fillGradientTable, m_fillGradient.stops);
     }
-    m_guiDirty |= DirtyColor;
+    m_guiDirty |= DirtyFillColor;
 }
 
 void QQuickPathRenderer::setStrokeColor(const QColor &color)
 {
+    // the node was gone, a new one needs the released geometry
+    if (m_strokeReleased && m_strokeColor.a == 0)
+        m_guiDirty |= DirtyStrokeGeom;
     m_strokeColor = colorToColor4ub(color);
-    m_guiDirty |= DirtyColor;
+    m_guiDirty |= DirtyStrokeColor;
 }
 
 void QQuickPathRenderer::setStrokeWidth(qreal w)
 {
+    const bool nodeRecreated = qFuzzyIsNull(m_pen.widthF());
     m_pen.setWidthF(w);
-    m_guiDirty |= DirtyGeom;
+    // extruded geometry only needs the new width passed to the shader
+    if (m_strokeExtruded && !(m_strokeReleased && nodeRecreated))
+        m_guiDirty |= DirtyStrokeWidth;
+    else
+        m_guiDirty |= DirtyStrokeGeom;
 }
 
 void QQuickPathRenderer::setFlags(RenderFlags flags)
 {
+    if (m_flags != flags)
+        m_fillPieces.clear();
     m_flags = flags;
-    m_guiDirty |= DirtyGeom;
+    m_guiDirty |= DirtyFillGeom | DirtyStrokeGeom;
 }
 
 void QQuickPathRenderer::setJoinStyle(QQuickPathItem::JoinStyle joinStyle, int miterLimit)
 {
+    if (m_pen.joinStyle() == Qt::PenJoinStyle(joinStyle) && m_pen.miterLimit() == miterLimit)
+        return;
     m_pen.setJoinStyle(Qt::PenJoinStyle(joinStyle));
     m_pen.setMiterLimit(miterLimit);
-    m_guiDirty |= DirtyGeom;
+    m_guiDirty |= DirtyStrokeGeom;
 }
 
 void QQuickPathRenderer::setCapStyle(QQuickPathItem::CapStyle capStyle)
 {
+    if (m_pen.capStyle() == Qt::PenCapStyle(capStyle))
+        return;
     m_pen.setCapStyle(Qt::PenCapStyle(capStyle));
-    m_guiDirty |= DirtyGeom;
+    m_guiDirty |= DirtyStrokeGeom;
 }
 
 void QQuickPathRenderer::setStrokeStyle(QQuickPathItem::StrokeStyle strokeStyle,
@@ -204,176 +454,2522 @@ void QQuickPathRenderer::setStrokeStyle(QQuickPathItem::StrokeStyle strokeStyle,
         m_pen.setDashOffset(dashOffset);
     }
     m_pen.setCosmetic(cosmeticStroke);
-    m_guiDirty |= DirtyGeom;
+    // extruded geometry is the same for all dash patterns
+    if (m_strokeExtruded && isExtrudable(m_pen))
+        m_guiDirty |= DirtyStrokeDash;
+    else
+        m_guiDirty |= DirtyStrokeGeom;
+}
+
+void QQuickPathRenderer::setAsyncCallback(void (*callback)(void *), void *data)
+{
+    m_asyncCallback = callback;
+    m_asyncCallbackData = data;
+}
+
+// Curve rendering falls back to flattening when it cannot handle the path.
+// Curve fills get no fringe, only their curved edges are antialiased.
+static void triangulateFillGeometry(const QVectorPath &vp, const QQuickPathRenderer::Color4ub &fillColor,
+                                    QQuickPathRenderer::FillGeometry *fill, bool supportsElementIndexUint,
+                                    bool antialiasing, bool curves, qreal scale)
+{
+    if (curves && QQuickPathRenderer::triangulateCurveFill(vp, fillColor, fill, supportsElementIndexUint, scale))
+        return;
+    QQuickPathRenderer::triangulateFill(vp, fillColor, fill, supportsElementIndexUint, antialiasing, scale);
+}
+
+// Triangulates the path with its own fill rule into fill and, unless it is
+// null, with the other rule into otherFill. Simple contours are only done
+// once. Curve fills are triangulated on the control polygon, which is not
+// checked.
+static void triangulateFillRules(const QPainterPath &path, const QQuickPathRenderer::Color4ub &fillColor,
+                                 QQuickPathRenderer::FillGeometry *fill,
+                                 QQuickPathRenderer::FillGeometry *otherFill,
+                                 bool supportsElementIndexUint, bool antialiasing, bool curves, qreal scale)
+{
+    const QVectorPath &vp = qtVectorPathForPath(path);
+    triangulateFillGeometry(vp, fillColor, fill, supportsElementIndexUint, antialiasing, curves, scale);
+    if (!otherFill)
+        return;
+    if (!curves && QQuickPathRenderer::isFillRuleIndependent(vp, triangulationScale(scale))) {
+        *otherFill = *fill;
+        return;
+    }
+    QPainterPath otherPath = path;
+    otherPath.setFillRule(path.fillRule() == Qt::OddEvenFill ? Qt::WindingFill : Qt::OddEvenFill);
+    triangulateFillGeometry(qtVectorPathForPath(otherPath), fillColor, otherFill, supportsElementIndexUint,
+                            antialiasing, curves, scale);
+}
+
+// Like triangulateFillRules() but paths that split up into independent pieces
+// only get the pieces triangulated that are not in previousPieces. Curve fills
+// are always done as a whole.
+static void triangulateFillIncrementally(const QPainterPath &path, const QQuickPathRenderer::Color4ub &fillColor,
+                                         QQuickPathRenderer::FillGeometry *fill,
+                                         QQuickPathRenderer::FillGeometry *otherFill,
+                                         bool supportsElementIndexUint, bool antialiasing, bool curves, qreal scale,
+                                         const QQuickPathRenderer::FillPieceContainer &previousPieces,
+                                         QQuickPathRenderer::FillPieceContainer *pieces,
+                                         int changedFirst, int changedLast)
+{
+    if (!curves && QQuickPathRenderer::triangulateFillPieces(path, fillColor, previousPieces, pieces, fill, otherFill,
+                                                             supportsElementIndexUint, antialiasing, scale,
+                                                             changedFirst, changedLast))
+        return;
+    pieces->clear();
+    triangulateFillRules(path, fillColor, fill, otherFill, supportsElementIndexUint, antialiasing, curves, scale);
+}
+
+// Extruded strokes get their width in the vertex shader and are dashed and
+// antialiased in the fragment shader instead of having a fringe. Whether the
+// pen can be extruded is decided on the gui thread, see isExtrudable().
+static void triangulateStrokeGeometry(const QVectorPath &vp, const QPen &pen, bool extruded,
+                                      const QQuickPathRenderer::Color4ub &strokeColor,
+                                      QQuickPathRenderer::VertexContainer *strokeVertices,
+                                      QQuickPathRenderer::FringeContainer *strokeFringe,
+                                      QQuickPathRenderer::ExtrudedVertexContainer *extrudedStrokeVertices,
+                                      const QSizeF &clipSize, bool antialiasing, qreal scale)
+{
+    if (extruded) {
+        strokeVertices->clear();
+        strokeFringe->clear();
+        QQuickPathRenderer::extrudeStroke(vp, pen, strokeColor, extrudedStrokeVertices, scale);
+        return;
+    }
+    extrudedStrokeVertices->clear();
+    QQuickPathRenderer::triangulateStroke(vp, pen, strokeColor, strokeVertices, clipSize,
+                                          antialiasing ? strokeFringe : nullptr, scale);
+    if (!antialiasing)
+        strokeFringe->clear();
 }
 
-void QQuickPathRenderer::endSync()
+void QQuickPathRenderer::endSync(bool async)
 {
     if (!m_guiDirty)
         return;
 
-    m_renderDirty |= m_guiDirty;
+    updateColorMode();
+
+    // Color and extruded stroke width changes do not need new geometry, the
+    // nodes take care of them.
+    m_renderDirty |= m_guiDirty & (DirtyFillColor | DirtyStrokeColor | DirtyStrokeWidth | DirtyStrokeDash
+                                   | DirtyStrokeTrim);
+    // the other rule's fill is ready, it only needs uploading
+    if (m_guiDirty & DirtyFillRule)
+        m_renderDirty |= DirtyFillGeom;
+
+    bool fillGeomDirty = m_guiDirty & DirtyFillGeom;
+    bool strokeGeomDirty = m_guiDirty & DirtyStrokeGeom;
+    if (!fillGeomDirty && !strokeGeomDirty)
+        return;
+
+    // Whatever is still being calculated for the affected side is based on
+    // outdated data. Let it run to completion (or skip the work if it has not
+    // started yet) but drop the results.
+    if (fillGeomDirty && m_pendingFill) {
+        m_pendingFill->orphaned.store(1);
+        m_pendingFill = nullptr;
+    }
+    if (strokeGeomDirty && m_pendingStroke) {
+        m_pendingStroke->orphaned.store(1);
+        m_pendingStroke = nullptr;
+    }
+
+    m_renderDirty |= m_guiDirty & (DirtyFillGeom | DirtyStrokeGeom);
+
+    if (fillGeomDirty) {
+        m_otherFillValid = false;
+        m_otherFill = FillGeometry();
+    }
+    // null until the rule changes
+    FillGeometry *otherFill = m_fillRuleToggled ? &m_otherFill : nullptr;
 
     if (m_path.isEmpty()) {
-        m_fillVertices.clear();
-        m_fillIndices.clear();
-        m_strokeVertices.clear();
+        if (fillGeomDirty) {
+            m_fill = FillGeometry();
+            m_otherFill = FillGeometry();
+            m_fillPieces.clear();
+            m_otherFillValid = true;
+            m_fillReleased = false;
+        }
+        if (strokeGeomDirty) {
+            m_strokeVertices.clear();
+            m_strokeFringe.clear();
+            m_extrudedStrokeVertices.clear();
+            m_strokeExtruded = false;
+            m_strokeReleased = false;
+        }
+        return;
+    }
+
+    const QSizeF clipSize(m_item->width(), m_item->height());
+    const bool elementIndexUint = supportsElementIndexUint();
+    const bool antialiasing = m_flags.testFlag(RenderAntialiased);
+    // without derivatives in the shader the curves get flattened like the rest
+    const bool curves = m_flags.testFlag(RenderCurves) && !m_fillGradientActive && supportsStandardDerivatives();
+    const bool trimmed = m_trimStart > 0 || m_trimEnd < 1;
+
+    // Rectangles and ellipses are cheap enough to generate directly.
+    if (!m_primitives.isEmpty()) {
+        if (fillGeomDirty && generatePrimitiveFill(m_primitives, m_fillColor, m_scale, &m_fill, antialiasing)) {
+            // the shapes do not overlap, the fill rule makes no difference
+            m_otherFill = m_fill;
+            m_otherFillValid = true;
+            m_fillReleased = false;
+            fillGeomDirty = false;
+        }
+        if (strokeGeomDirty && !trimmed
+                && generatePrimitiveStroke(m_primitives, m_pen, m_strokeColor, m_scale, &m_strokeVertices,
+                                           antialiasing ? &m_strokeFringe : nullptr)) {
+            if (!antialiasing)
+                m_strokeFringe.clear();
+            // cheap enough to generate again when the width changes
+            m_extrudedStrokeVertices.clear();
+            m_strokeExtruded = false;
+            m_strokeReleased = false;
+            strokeGeomDirty = false;
+        }
+        if (!fillGeomDirty && !strokeGeomDirty) {
+            if (async)
+                maybeUpdateAsyncItem();
+            return;
+        }
+    }
+
+    // Extruded strokes get trimmed in the shader, the others need a shorter path.
+    QPainterPath strokePath = m_path;
+    if (strokeGeomDirty) {
+        m_strokeExtruded = isExtrudable(m_pen);
+        if (trimmed && !m_strokeExtruded)
+            strokePath = trimPath(m_path, m_trimStart, m_trimEnd);
+    }
+
+    // Other items may have triangulated the same geometry already.
+    QQuickPathTriangulationCache *cache = QQuickPathTriangulationCache::instance();
+    QQuickPathTriangulationCache::Key fillKey;
+    QQuickPathTriangulationCache::Key strokeKey;
+    const bool useCache = cache->isEnabled();
+    if (useCache) {
+        if (fillGeomDirty) {
+            fillKey = QQuickPathTriangulationCache::fillKey(m_path, elementIndexUint, antialiasing, curves, m_scale);
+            if (cache->findFill(fillKey, &m_fill, otherFill)) {
+                m_otherFillValid = otherFill != nullptr;
+                m_fillReleased = false;
+                fillGeomDirty = false;
+            }
+        }
+        if (strokeGeomDirty) {
+            strokeKey = QQuickPathTriangulationCache::strokeKey(strokePath, m_pen, clipSize, antialiasing, m_scale);
+            if (cache->findStroke(strokeKey, &m_strokeVertices, &m_strokeFringe, &m_extrudedStrokeVertices)) {
+                m_strokeReleased = false;
+                strokeGeomDirty = false;
+            }
+        }
+        if (!fillGeomDirty && !strokeGeomDirty) {
+            if (async)
+                maybeUpdateAsyncItem();
+            return;
+        }
+    }
+
+    // The path is converted once, the fill and stroke share the result. This
+    // also makes sure the lazily created, cached QVectorPath exists before
+    // the asynchronous jobs get to use it in parallel.
+    const QVectorPath &vp = qtVectorPathForPath(m_path);
+    vp.controlPointRect();
+    const QVectorPath &strokeVp = qtVectorPathForPath(strokePath);
+    strokeVp.controlPointRect();
+
+    if (!async) {
+        if (fillGeomDirty) {
+            triangulateFillIncrementally(m_path, m_fillColor, &m_fill, otherFill, elementIndexUint, antialiasing,
+                                         curves, m_scale, m_fillPieces, &m_fillPieces,
+                                         m_piecesChangeFirst, m_piecesChangeLast);
+            m_otherFillValid = otherFill != nullptr;
+            m_fillReleased = false;
+            m_piecesChangeFirst = INT_MAX;
+            m_piecesChangeLast = -1;
+            if (useCache)
+                cache->insertFill(fillKey, m_fill, otherFill);
+        }
+        if (strokeGeomDirty) {
+            triangulateStrokeGeometry(strokeVp, m_pen, m_strokeExtruded, m_strokeColor, &m_strokeVertices,
+                                      &m_strokeFringe, &m_extrudedStrokeVertices, clipSize, antialiasing, m_scale);
+            m_strokeReleased = false;
+            if (useCache)
+                cache->insertStroke(strokeKey, m_strokeVertices, m_strokeFringe, m_extrudedStrokeVertices);
+        }
+        return;
+    }
+
+    // The geometry bits get set again when the results arrive.
+    if (fillGeomDirty)
+        m_renderDirty &= ~DirtyFillGeom;
+    if (strokeGeomDirty)
+        m_renderDirty &= ~DirtyStrokeGeom;
+
+    if (fillGeomDirty) {
+        QQuickPathFillRunnable *r = new QQuickPathFillRunnable;
+        r->setAutoDelete(false);
+        r->path = m_path;
+        r->fillColor = m_fillColor;
+        r->supportsElementIndexUint = elementIndexUint;
+        r->antialiasing = antialiasing;
+        r->curves = curves;
+        r->bothRules = otherFill != nullptr;
+        r->scale = m_scale;
+        r->previousPieces = m_fillPieces;
+        r->changedFirst = m_piecesChangeFirst;
+        r->changedLast = m_piecesChangeLast;
+        QObject::connect(r, &QQuickPathFillRunnable::done, qApp, [this, useCache, fillKey](QQuickPathFillRunnable *r) {
+            // the renderer may be gone already when orphaned, do not touch it in that case
+            if (!r->orphaned.load()) {
+                // the rule may have changed in the meantime, which means
+                // both were triangulated
+                const bool sameRule = r->path.fillRule() == m_path.fillRule();
+                m_fill = sameRule ? r->fill : r->otherFill;
+                m_otherFill = sameRule ? r->otherFill : r->fill;
+                m_otherFillValid = r->bothRules;
+                m_fillReleased = false;
+                m_fillPieces = r->pieces;
+                m_piecesChangeFirst = INT_MAX;
+                m_piecesChangeLast = -1;
+                if (useCache)
+                    QQuickPathTriangulationCache::instance()->insertFill(fillKey, r->fill,
+                                                                         r->bothRules ? &r->otherFill : nullptr);
+                m_pendingFill = nullptr;
+                m_renderDirty |= DirtyFillGeom;
+                maybeUpdateAsyncItem();
+            }
+            r->deleteLater();
+        });
+        m_pendingFill = r;
+        qt_path_worker_pool()->start(r);
+    }
+
+    if (strokeGeomDirty) {
+        QQuickPathStrokeRunnable *r = new QQuickPathStrokeRunnable;
+        r->setAutoDelete(false);
+        r->path = strokePath;
+        r->pen = m_pen;
+        r->extruded = m_strokeExtruded;
+        r->strokeColor = m_strokeColor;
+        r->clipSize = clipSize;
+        r->antialiasing = antialiasing;
+        r->scale = m_scale;
+        QObject::connect(r, &QQuickPathStrokeRunnable::done, qApp, [this, useCache, strokeKey](QQuickPathStrokeRunnable *r) {
+            if (!r->orphaned.load()) {
+                m_strokeVertices = r->strokeVertices;
+                m_strokeFringe = r->strokeFringe;
+                m_extrudedStrokeVertices = r->extrudedStrokeVertices;
+                m_strokeReleased = false;
+                if (useCache)
+                    QQuickPathTriangulationCache::instance()->insertStroke(strokeKey, m_strokeVertices, m_strokeFringe,
+                                                                           m_extrudedStrokeVertices);
+                m_pendingStroke = nullptr;
+                m_renderDirty |= DirtyStrokeGeom;
+                maybeUpdateAsyncItem();
+            }
+            r->deleteLater();
+        });
+        m_pendingStroke = r;
+        qt_path_worker_pool()->start(r);
+    }
+}
+
+// Automatic mode passes the color as a uniform once it changed in a few
+// syncs in a row without anything else changing, i.e. while it is being
+// animated, and goes back to vertex colors, which keep different items
+// batchable, with the next sync that changes something else. When nothing
+// changes at all, advanceFrame() asks for that sync after a while. The nodes
+// convert their geometry, it does not need to be generated again.
+void QQuickPathRenderer::updateColorMode()
+{
+    m_idleFrames = 0;
+
+    const int colorDirty = DirtyFillColor | DirtyStrokeColor;
+    const bool colorOnly = (m_guiDirty & colorDirty) && !(m_guiDirty & ~colorDirty);
+    m_colorOnlySyncs = colorOnly ? m_colorOnlySyncs + 1 : 0;
+
+    const bool uniform = m_colorMode == QQuickPathItem::UniformColor
+            || (m_colorMode == QQuickPathItem::AutomaticColor && m_colorOnlySyncs >= 2);
+    if (uniform != m_uniformColor) {
+        m_uniformColor = uniform;
+        m_guiDirty |= colorDirty;
+    }
+}
+
+// Frames without a sync before automatic mode goes back to vertex colors.
+static const int VERTEX_COLOR_IDLE_FRAMES = 60;
+
+bool QQuickPathRenderer::advanceFrame()
+{
+    if (m_colorMode != QQuickPathItem::AutomaticColor || !m_uniformColor)
+        return false;
+    return ++m_idleFrames == VERTEX_COLOR_IDLE_FRAMES;
+}
+
+void QQuickPathRenderer::maybeUpdateAsyncItem()
+{
+    if (m_pendingFill || m_pendingStroke)
         return;
+
+    if (m_asyncCallback)
+        m_asyncCallback(m_asyncCallbackData);
+}
+
+void QQuickPathFillRunnable::run()
+{
+    if (!orphaned.load())
+        triangulateFillIncrementally(path, fillColor, &fill, bothRules ? &otherFill : nullptr,
+                                     supportsElementIndexUint, antialiasing, curves, scale, previousPieces, &pieces,
+                                     changedFirst, changedLast);
+    emit done(this);
+}
+
+void QQuickPathStrokeRunnable::run()
+{
+    if (!orphaned.load())
+        triangulateStrokeGeometry(qtVectorPathForPath(path), pen, extruded, strokeColor, &strokeVertices,
+                                  &strokeFringe, &extrudedStrokeVertices, clipSize, antialiasing, scale);
+    emit done(this);
+}
+
+struct QQuickPathGLCapabilities
+{
+    bool elementIndexUint;
+    bool standardDerivatives;
+};
+
+// Probes the OpenGL implementation once, with a dummy context when there is
+// no current one. Everything is off unless the probe says otherwise, the
+// fallbacks work everywhere.
+static const QQuickPathGLCapabilities &glCapabilities()
+{
+    static QQuickPathGLCapabilities caps = { false, false };
+#ifndef QT_NO_OPENGL
+    static bool checked = false;
+    if (!checked) {
+        checked = true;
+        QOpenGLContext *context = QOpenGLContext::currentContext();
+        QScopedPointer<QOpenGLContext> dummyContext;
+        QScopedPointer<QOffscreenSurface> dummySurface;
+        bool ok = true;
+        if (!context) {
+            dummyContext.reset(new QOpenGLContext);
+            ok = dummyContext->create();
+            context = dummyContext.data();
+            if (ok) {
+                dummySurface.reset(new QOffscreenSurface);
+                dummySurface->setFormat(context->format());
+                dummySurface->create();
+                ok = dummySurface->isValid() && context->makeCurrent(dummySurface.data());
+            }
+        }
+        if (ok) {
+            QOpenGLExtensions *e = static_cast<QOpenGLExtensions *>(context->functions());
+            caps.elementIndexUint = e->hasOpenGLExtension(QOpenGLExtensions::ElementIndexUint);
+            // dFdx() and friends are core in desktop GLSL and in OpenGL ES 3
+            caps.standardDerivatives = !context->isOpenGLES() || context->format().majorVersion() >= 3
+                    || context->hasExtension(QByteArrayLiteral("GL_OES_standard_derivatives"));
+            if (dummyContext)
+                dummyContext->doneCurrent();
+        }
     }
+#endif
+    return caps;
+}
 
-    triangulateFill();
-    triangulateStroke();
+// Must be called on the gui thread. The result is used to decide if large
+// fills can be drawn with 32-bit indices or need to be split up.
+bool QQuickPathRenderer::supportsElementIndexUint()
+{
+    return glCapabilities().elementIndexUint;
 }
 
-void QQuickPathRenderer::triangulateFill()
+// Must be called on the gui thread. Curve fills and extruded strokes are
+// antialiased with screen space derivatives in their fragment shaders.
+bool QQuickPathRenderer::supportsStandardDerivatives()
 {
-    const QVectorPath &vp = qtVectorPathForPath(m_path);
+    return glCapabilities().standardDerivatives;
+}
 
-    QTriangleSet ts = qTriangulate(vp, QTransform::fromScale(SCALE, SCALE));
+// Appends the triangles as a new range, with indices relative to the range's first vertex.
+static void appendTriangleSet(const QTriangleSet &ts, qreal scale,
+                              const QQuickPathRenderer::Color4ub &fillColor,
+                              QQuickPathRenderer::FillGeometry *fill)
+{
+    const int vertexStart = fill->vertices.count();
+    const int indexStart = fill->indices.count();
     const int vertexCount = ts.vertices.count() / 2; // just a qreal vector with x,y hence the / 2
-    m_fillVertices.resize(vertexCount);
-    ColoredVertex *vdst = reinterpret_cast<ColoredVertex *>(m_fillVertices.data());
+    const int indexCount = ts.indices.size();
+
+    fill->vertices.resize(vertexStart + vertexCount);
+    ColoredVertex *vdst = reinterpret_cast<ColoredVertex *>(fill->vertices.data()) + vertexStart;
     const qreal *vsrc = ts.vertices.constData();
     for (int i = 0; i < vertexCount; ++i)
-        vdst[i].set(vsrc[i * 2] / SCALE, vsrc[i * 2 + 1] / SCALE, m_fillColor);
+        vdst[i].set(vsrc[i * 2] / scale, vsrc[i * 2 + 1] / scale, fillColor);
 
-    m_fillIndices.resize(ts.indices.size());
-    quint16 *idst = m_fillIndices.data();
+    fill->indices.resize(indexStart + indexCount);
+    quint32 *idst = fill->indices.data() + indexStart;
     if (ts.indices.type() == QVertexIndexVector::UnsignedShort) {
-        memcpy(idst, ts.indices.data(), m_fillIndices.count() * sizeof(quint16));
-    } else {
-        const quint32 *isrc = (const quint32 *) ts.indices.data();
-        for (int i = 0; i < m_fillIndices.count(); ++i)
+        const quint16 *isrc = static_cast<const quint16 *>(ts.indices.data());
+        for (int i = 0; i < indexCount; ++i)
             idst[i] = isrc[i];
+    } else {
+        memcpy(idst, ts.indices.data(), indexCount * sizeof(quint32));
     }
+
+    QQuickPathRenderer::FillRange range = { vertexStart, vertexCount, indexStart, indexCount };
+    fill->ranges.append(range);
 }
 
-void QQuickPathRenderer::triangulateStroke()
+// Sutherland-Hodgman against a horizontal line. The winding number of the
+// points on the kept side is preserved, so this works for any fill rule.
+static void clipPolygon(const QPolygonF &src, qreal y, bool keepAbove, QPolygonF *dst)
 {
-    const QVectorPath &vp = qtVectorPathForPath(m_path);
+    dst->clear();
+    if (src.isEmpty())
+        return;
 
-    const QRectF clip(0, 0, m_item->width(), m_item->height());
-    const qreal inverseScale = 1.0 / SCALE;
-    m_stroker.setInvScale(inverseScale);
-    if (m_pen.style() == Qt::SolidLine) {
-        m_stroker.process(vp, m_pen, clip, 0);
-    } else {
-        m_dashStroker.setInvScale(inverseScale);
-        m_dashStroker.process(vp, m_pen, clip, 0);
-        QVectorPath dashStroke(m_dashStroker.points(), m_dashStroker.elementCount(),
-                               m_dashStroker.elementTypes(), 0);
-        m_stroker.process(dashStroke, m_pen, clip, 0);
+    QPointF prev = src.last();
+    bool prevInside = keepAbove ? prev.y() <= y : prev.y() >= y;
+    for (const QPointF &cur : src) {
+        const bool curInside = keepAbove ? cur.y() <= y : cur.y() >= y;
+        if (curInside != prevInside) {
+            const qreal t = (y - prev.y()) / (cur.y() - prev.y());
+            dst->append(QPointF(prev.x() + t * (cur.x() - prev.x()), y));
+        }
+        if (curInside)
+            dst->append(cur);
+        prev = cur;
+        prevInside = curInside;
     }
+}
 
-    if (!m_stroker.vertexCount()) {
-        m_strokeVertices.clear();
-        return;
+// Fills with more vertices than what 16-bit indices can address are cut into
+// horizontal bands that get triangulated separately. Doing this on the input
+// is necessary since qTriangulate() only produces 32-bit indices when called
+// with a suitable OpenGL context current, which is not the case here.
+static void triangulateFillInBands(const QPainterPath &path, int vertexCountHint, qreal scale,
+                                   const QQuickPathRenderer::Color4ub &fillColor,
+                                   QQuickPathRenderer::FillGeometry *fill)
+{
+    const QList<QPolygonF> polys = path.toSubpathPolygons(QTransform::fromScale(scale, scale));
+    QRectF bounds;
+    for (const QPolygonF &poly : polys)
+        bounds |= poly.boundingRect();
+
+    // Band edges are kept at integer coordinates in the scaled space so that
+    // the triangulator's rounding cannot introduce gaps between the bands.
+    const qreal top = qFloor(bounds.top());
+    const qreal bottom = qCeil(bounds.bottom());
+    const int bandCount = qMax(2, 2 * vertexCountHint / MAX_USHORT_VERTICES + 1);
+    const qreal bandHeight = qMax<qreal>(1, qCeil((bottom - top) / bandCount));
+
+    // work list of [y0, y1) intervals, processed top to bottom
+    QVector<QPair<qreal, qreal> > bands;
+    for (qreal y = bottom; y > top; y -= bandHeight)
+        bands.append(qMakePair(qMax(top, y - bandHeight), y));
+
+    QPolygonF tmp, clipped;
+    while (!bands.isEmpty()) {
+        const QPair<qreal, qreal> band = bands.takeLast();
+        QPainterPath bandPath;
+        bandPath.setFillRule(path.fillRule());
+        for (const QPolygonF &poly : polys) {
+            clipPolygon(poly, band.first, false, &tmp);
+            clipPolygon(tmp, band.second, true, &clipped);
+            if (clipped.count() >= 3) {
+                bandPath.addPolygon(clipped);
+                bandPath.closeSubpath();
+            }
+        }
+        if (bandPath.isEmpty())
+            continue;
+
+        const QTriangleSet ts = qTriangulate(bandPath);
+        if (ts.vertices.count() / 2 > MAX_USHORT_VERTICES && ts.indices.type() == QVertexIndexVector::UnsignedShort) {
+            const qreal mid = qFloor((band.first + band.second) / 2);
+            if (mid > band.first) {
+                bands.append(qMakePair(mid, band.second));
+                bands.append(qMakePair(band.first, mid));
+                continue;
+            }
+            qWarning("Path too complex, fill will be rendered incorrectly");
+        }
+        appendTriangleSet(ts, scale, fillColor, fill);
     }
+}
 
-    const int vertexCount = m_stroker.vertexCount() / 2; // just a float vector with x,y hence the / 2
-    m_strokeVertices.resize(vertexCount);
-    ColoredVertex *vdst = reinterpret_cast<ColoredVertex *>(m_strokeVertices.data());
-    const float *vsrc = m_stroker.vertices();
-    for (int i = 0; i < vertexCount; ++i)
-        vdst[i].set(vsrc[i * 2], vsrc[i * 2 + 1], m_strokeColor);
+const QSGGeometry::AttributeSet &QQuickPathRenderer::smoothColoredAttributes()
+{
+    static QSGGeometry::Attribute data[] = {
+        QSGGeometry::Attribute::create(0, 2, QSGGeometry::FloatType, true),
+        QSGGeometry::Attribute::create(1, 4, QSGGeometry::UnsignedByteType, false),
+        QSGGeometry::Attribute::create(2, 2, QSGGeometry::FloatType, false)
+    };
+    static QSGGeometry::AttributeSet attrs = { 3, sizeof(SmoothColoredPoint2D), data };
+    return attrs;
 }
 
-void QQuickPathRenderer::updatePathRenderNode()
+// the fringe is this many device pixels wide
+static const float FRINGE_WIDTH = 1.0f;
+
+// limits the length of the offset at sharp corners, like a miter limit
+static const float FRINGE_MITER_LIMIT = 4.0f;
+
+static inline qreal cross(const QPointF &a, const QPointF &b)
 {
-    if (!m_renderDirty || !m_rootNode)
-        return;
+    return a.x() * b.y() - a.y() * b.x();
+}
 
-    if (m_fillColor.a == 0) {
-        delete m_rootNode->m_fillNode;
-        m_rootNode->m_fillNode = nullptr;
-    } else if (!m_rootNode->m_fillNode) {
-        m_rootNode->m_fillNode = new QQuickPathRenderNode(m_item->window(), m_rootNode);
-        if (m_rootNode->m_strokeNode)
-            m_rootNode->removeChildNode(m_rootNode->m_strokeNode);
-        m_rootNode->appendChildNode(m_rootNode->m_fillNode);
-        if (m_rootNode->m_strokeNode)
-            m_rootNode->appendChildNode(m_rootNode->m_strokeNode);
-        m_renderDirty |= DirtyGeom;
+static int windingNumber(const QPolygonF &poly, const QPointF &pt)
+{
+    int w = 0;
+    const int n = poly.count();
+    for (int i = 0; i < n; ++i) {
+        const QPointF &a = poly.at(i);
+        const QPointF &b = poly.at((i + 1) % n);
+        if (a.y() <= pt.y()) {
+            if (b.y() > pt.y() && cross(b - a, pt - a) > 0)
+                ++w;
+        } else if (b.y() <= pt.y() && cross(b - a, pt - a) < 0) {
+            --w;
+        }
     }
+    return w;
+}
 
-    if (qFuzzyIsNull(m_pen.widthF()) || m_strokeColor.a == 0) {
-        delete m_rootNode->m_strokeNode;
-        m_rootNode->m_strokeNode = nullptr;
-    } else if (!m_rootNode->m_strokeNode) {
-        m_rootNode->m_strokeNode = new QQuickPathRenderNode(m_item->window(), m_rootNode);
-        m_rootNode->appendChildNode(m_rootNode->m_strokeNode);
-        m_renderDirty |= DirtyGeom;
+// Returns true when the area to the right of contour ci (in y-down
+// coordinates, i.e. clockwise on screen) is filled. Tests a point just next
+// to the longest edge against all contours.
+static bool rightIsInside(const QVector<QPolygonF> &contours, const QVector<QRectF> &bounds,
+                          int ci, Qt::FillRule fillRule)
+{
+    const QPolygonF &c(contours.at(ci));
+    const int n = c.count();
+    int longest = 0;
+    qreal longestLen = 0;
+    for (int i = 0; i < n; ++i) {
+        const QPointF d = c.at((i + 1) % n) - c.at(i);
+        const qreal len = d.x() * d.x() + d.y() * d.y();
+        if (len > longestLen) {
+            longest = i;
+            longestLen = len;
+        }
     }
+    const QPointF d = c.at((longest + 1) % n) - c.at(longest);
+    const QPointF testPt = (c.at(longest) + c.at((longest + 1) % n)) / 2 + QPointF(d.y(), -d.x()) * 1e-3;
+    int w = 0;
+    for (int i = 0; i < contours.count(); ++i) {
+        const QRectF &r(bounds.at(i));
+        if (testPt.y() >= r.top() && testPt.y() <= r.bottom() && testPt.x() <= r.right())
+            w += windingNumber(contours.at(i), testPt);
+    }
+    return fillRule == Qt::WindingFill ? w != 0 : (w & 1);
+}
 
-    updateFillNode();
-    updateStrokeNode();
-
-    m_renderDirty = 0;
+static inline void appendFringeVertex(QQuickPathRenderer::FringeContainer *fringe, const QPointF &pt,
+                                      const QQuickPathRenderer::Color4ub &color, float dx, float dy)
+{
+    const QQuickPathRenderer::SmoothColoredPoint2D v = { float(pt.x()), float(pt.y()),
+                                                         color.r, color.g, color.b, color.a,
+                                                         dx, dy };
+    fringe->append(v);
 }
 
-void QQuickPathRenderer::updateFillNode()
+// Generates a strip of triangles along the outline, going from the given
+// color on the edge to transparent FRINGE_WIDTH pixels outside. The outside
+// of each contour is found by testing the winding number next to it, which
+// also handles holes, whatever their orientation is. The polygons are
+// expected to be in the same scaled space the triangulator works in.
+static void appendFringe(const QList<QPolygonF> &polys, Qt::FillRule fillRule, qreal scale,
+                         const QQuickPathRenderer::Color4ub &color,
+                         QQuickPathRenderer::FringeContainer *fringe)
 {
-    if (!m_rootNode->m_fillNode)
-        return;
+    QVector<QPolygonF> contours;
+    QVector<QRectF> bounds;
+    contours.reserve(polys.count());
+    bounds.reserve(polys.count());
+    for (const QPolygonF &poly : polys) {
+        QPolygonF c;
+        c.reserve(poly.count());
+        for (const QPointF &pt : poly) {
+            if (c.isEmpty() || c.last() != pt)
+                c.append(pt);
+        }
+        while (c.count() > 1 && c.last() == c.first())
+            c.removeLast();
+        if (c.count() >= 3) {
+            bounds.append(c.boundingRect());
+            contours.append(c);
+        }
+    }
 
-    QQuickPathRenderNode *n = m_rootNode->m_fillNode;
-    n->markDirty(QSGNode::DirtyGeometry);
+    const QQuickPathRenderer::Color4ub transparent = { 0, 0, 0, 0 };
 
-    QSGGeometry *g = &n->m_geometry;
-    if (m_fillVertices.isEmpty()) {
-        g->allocate(0, 0);
-        return;
-    }
+    for (int ci = 0; ci < contours.count(); ++ci) {
+        const QPolygonF &c(contours.at(ci));
+        const int n = c.count();
 
-    n->m_dirty = m_renderDirty;
+        const qreal side = rightIsInside(contours, bounds, ci, fillRule) ? -1 : 1;
 
-    const bool onlyColorDirty = (m_renderDirty & DirtyColor) && !(m_renderDirty & DirtyGeom);
-    if (!m_fillGradientActive) {
-        n->activateMaterial(QQuickPathRenderNode::MatSolidColor);
-        if (onlyColorDirty) {
-            ColoredVertex *vdst = reinterpret_cast<ColoredVertex *>(g->vertexData());
-            for (int i = 0; i < g->vertexCount(); ++i)
-                vdst[i].set(vdst[i].x, vdst[i].y, m_fillColor);
-            return;
+        // outward normals of the edges
+        QVector<QPointF> normals(n);
+        for (int i = 0; i < n; ++i) {
+            const QPointF e = c.at((i + 1) % n) - c.at(i);
+            const qreal len = qSqrt(e.x() * e.x() + e.y() * e.y());
+            normals[i] = QPointF(e.y(), -e.x()) * (side / len);
         }
-    } else {
-        n->activateMaterial(QQuickPathRenderNode::MatLinearGradient);
-        if (m_renderDirty & DirtyColor)
-            n->markDirty(QSGNode::DirtyMaterial);
-        if (onlyColorDirty)
-            return;
-    }
 
-    g->allocate(m_fillVertices.count(), m_fillIndices.count());
-    g->setDrawingMode(QSGGeometry::DrawTriangles);
-    memcpy(g->vertexData(), m_fillVertices.constData(), g->vertexCount() * g->sizeOfVertex());
-    memcpy(g->indexData(), m_fillIndices.constData(), g->indexCount() * g->sizeOfIndex());
+        // connect to the previous contour with degenerate triangles
+        if (!fringe->isEmpty()) {
+            fringe->append(fringe->last());
+            appendFringeVertex(fringe, c.first() / scale, color, 0, 0);
+        }
+
+        for (int j = 0; j <= n; ++j) {
+            const int i = j % n;
+            const QPointF &n0(normals.at((i + n - 1) % n));
+            const QPointF &n1(normals.at(i));
+            QPointF m = n0 + n1;
+            const qreal len = qSqrt(m.x() * m.x() + m.y() * m.y());
+            if (len < 1e-6) {
+                m = n0;
+            } else {
+                m /= len;
+                const qreal cosHalf = m.x() * n0.x() + m.y() * n0.y();
+                m *= qMin(FRINGE_MITER_LIMIT, float(1 / qMax<qreal>(cosHalf, 1e-6)));
+            }
+            const QPointF pt = c.at(i) / scale;
+            appendFringeVertex(fringe, pt, color, 0, 0);
+            appendFringeVertex(fringe, pt, transparent, m.x() * FRINGE_WIDTH, m.y() * FRINGE_WIDTH);
+        }
+    }
 }
 
-void QQuickPathRenderer::updateStrokeNode()
+// Polygons up to this size that are not convex go through the ear clipper
+// instead of qTriangulate(), which has a high fixed cost.
+static const int MAX_EAR_CLIP_VERTICES = 64;
+
+// Drops repeated points, including an explicit closing one.
+static void removeRepeatedPoints(QPolygonF *poly)
 {
-    if (!m_rootNode->m_strokeNode)
-        return;
+    QPointF *d = poly->data();
+    int n = 0;
+    for (int i = 0; i < poly->count(); ++i) {
+        if (n == 0 || d[i] != d[n - 1])
+            d[n++] = d[i];
+    }
+    while (n > 1 && d[n - 1] == d[0])
+        --n;
+    poly->resize(n);
+}
 
-    QQuickPathRenderNode *n = m_rootNode->m_strokeNode;
-    n->markDirty(QSGNode::DirtyGeometry);
+// Flattens the path into a single polygon, in the scaled space qTriangulate()
+// works in so that curves get the same tolerance. Returns false when there is
+// more than one subpath.
+static bool toSingleContour(const QVectorPath &vp, qreal scale, QPolygonF *poly)
+{
+    const QPainterPath::ElementType *types = vp.elements();
+    const QPointF *pts = reinterpret_cast<const QPointF *>(vp.points());
+    const int count = vp.elementCount();
+    poly->clear();
+    poly->reserve(count);
 
-    QSGGeometry *g = &n->m_geometry;
-    if (m_strokeVertices.isEmpty()) {
-        g->allocate(0, 0);
-        return;
+    for (int i = 0; i < count; ++i) {
+        const QPointF pt = pts[i] * scale;
+        if (!types) {
+            poly->append(pt);
+            continue;
+        }
+        switch (types[i]) {
+        case QPainterPath::MoveToElement:
+            if (i > 0)
+                return false;
+            poly->append(pt);
+            break;
+        case QPainterPath::LineToElement:
+            poly->append(pt);
+            break;
+        case QPainterPath::CurveToElement:
+            if (i == 0 || i + 2 >= count)
+                return false;
+            QBezier::fromPoints(pts[i - 1] * scale, pt, pts[i + 1] * scale, pts[i + 2] * scale).addToPolygon(poly);
+            i += 2;
+            break;
+        default:
+            return false;
+        }
     }
 
-    if ((m_renderDirty & DirtyColor) && !(m_renderDirty & DirtyGeom)) {
-        ColoredVertex *vdst = reinterpret_cast<ColoredVertex *>(g->vertexData());
-        for (int i = 0; i < g->vertexCount(); ++i)
-            vdst[i].set(vdst[i].x, vdst[i].y, m_strokeColor);
-        return;
-    }
+    removeRepeatedPoints(poly);
+    return true;
+}
 
-    g->allocate(m_strokeVertices.count(), 0);
+static inline qreal cross(const QPointF &o, const QPointF &a, const QPointF &b)
+{
+    return (a.x() - o.x()) * (b.y() - o.y()) - (a.y() - o.y()) * (b.x() - o.x());
+}
+
+static inline int sign(qreal v)
+{
+    return v > 0 ? 1 : (v < 0 ? -1 : 0);
+}
+
+// Counts the direction changes along one axis, going around the whole polygon.
+static int directionChanges(const QPolygonF &poly, bool vertical)
+{
+    const int n = poly.count();
+    int changes = 0;
+    int first = 0;
+    int last = 0;
+    for (int i = 0; i < n; ++i) {
+        const QPointF d = poly.at((i + 1) % n) - poly.at(i);
+        const int s = sign(vertical ? d.y() : d.x());
+        if (!s)
+            continue;
+        if (!first)
+            first = s;
+        else if (s != last)
+            ++changes;
+        last = s;
+    }
+    if (first && last != first)
+        ++changes;
+    return changes;
+}
+
+// Convex when all the turns go the same way and the outline goes around only
+// once. The latter rules out star shapes like the pentagram.
+static bool isConvex(const QPolygonF &poly)
+{
+    const int n = poly.count();
+    int turn = 0;
+    for (int i = 0; i < n; ++i) {
+        const int s = sign(cross(poly.at(i), poly.at((i + 1) % n), poly.at((i + 2) % n)));
+        if (!s)
+            continue;
+        if (turn && s != turn)
+            return false;
+        turn = s;
+    }
+    return turn && directionChanges(poly, false) <= 2 && directionChanges(poly, true) <= 2;
+}
+
+static inline bool onSegment(const QPointF &a, const QPointF &b, const QPointF &p)
+{
+    return qMin(a.x(), b.x()) <= p.x() && p.x() <= qMax(a.x(), b.x())
+        && qMin(a.y(), b.y()) <= p.y() && p.y() <= qMax(a.y(), b.y());
+}
+
+// Touching and overlapping counts as intersecting too.
+static bool segmentsIntersect(const QPointF &p1, const QPointF &p2, const QPointF &q1, const QPointF &q2)
+{
+    const int d1 = sign(cross(q1, q2, p1));
+    const int d2 = sign(cross(q1, q2, p2));
+    const int d3 = sign(cross(p1, p2, q1));
+    const int d4 = sign(cross(p1, p2, q2));
+    if (d1 * d2 < 0 && d3 * d4 < 0)
+        return true;
+    return (!d1 && onSegment(q1, q2, p1)) || (!d2 && onSegment(q1, q2, p2))
+        || (!d3 && onSegment(p1, p2, q1)) || (!d4 && onSegment(p1, p2, q2));
+}
+
+// O(n^2), only meant for small polygons.
+static bool isSimple(const QPolygonF &poly)
+{
+    const int n = poly.count();
+    for (int i = 0; i < n; ++i) {
+        for (int j = i + 2; j < n; ++j) {
+            if (i == 0 && j == n - 1)
+                continue; // adjacent
+            if (segmentsIntersect(poly.at(i), poly.at(i + 1), poly.at(j), poly.at((j + 1) % n)))
+                return false;
+        }
+    }
+    return true;
+}
+
+// Ear clipping for small polygons. Returns false when the polygon is not
+// simple, in which case the fill rule matters and qTriangulate() is needed.
+static bool earClip(const QPolygonF &poly, QQuickPathRenderer::IndexContainer *indices)
+{
+    const int n = poly.count();
+    if (!isSimple(poly))
+        return false;
+
+    qreal area = 0;
+    for (int i = 0; i < n; ++i)
+        area += cross(QPointF(), poly.at(i), poly.at((i + 1) % n));
+
+    QVarLengthArray<quint32, MAX_EAR_CLIP_VERTICES> idx(n);
+    for (int i = 0; i < n; ++i)
+        idx[i] = area > 0 ? i : n - 1 - i;
+
+    indices->reserve((n - 2) * 3);
+    int remaining = n;
+    int i = 0;
+    int misses = 0;
+    while (remaining > 3) {
+        if (misses > remaining)
+            return false; // no ear left, can only happen with degenerate input
+        const int prev = (i + remaining - 1) % remaining;
+        const int next = (i + 1) % remaining;
+        const QPointF &a(poly.at(idx[prev]));
+        const QPointF &b(poly.at(idx[i]));
+        const QPointF &c(poly.at(idx[next]));
+        bool ear = cross(a, b, c) > 0;
+        for (int k = 0; ear && k < remaining; ++k) {
+            if (k == prev || k == i || k == next)
+                continue;
+            const QPointF &p(poly.at(idx[k]));
+            ear = cross(a, b, p) < 0 || cross(b, c, p) < 0 || cross(c, a, p) < 0;
+        }
+        if (ear) {
+            indices->append(idx[prev]);
+            indices->append(idx[i]);
+            indices->append(idx[next]);
+            memmove(idx.data() + i, idx.data() + i + 1, (remaining - i - 1) * sizeof(quint32));
+            --remaining;
+            if (i >= remaining)
+                i = 0;
+            misses = 0;
+        } else {
+            i = (i + 1) % remaining;
+            ++misses;
+        }
+    }
+    indices->append(idx[0]);
+    indices->append(idx[1]);
+    indices->append(idx[2]);
+    return true;
+}
+
+// Handles the common case of a single contour that is either convex (fan) or
+// small and simple (ear clipping), avoiding the sweep line triangulator.
+// Returns false when the path needs qTriangulate().
+static bool triangulateSimpleFill(const QVectorPath &vp, qreal scale,
+                                  const QQuickPathRenderer::Color4ub &fillColor,
+                                  QQuickPathRenderer::FillGeometry *fill)
+{
+    QPolygonF poly;
+    if (!toSingleContour(vp, scale, &poly))
+        return false;
+
+    const int n = poly.count();
+    if (n > MAX_USHORT_VERTICES)
+        return false;
+    if (n < 3)
+        return true; // nothing to fill
+
+    if (isConvex(poly)) {
+        fill->indices.resize((n - 2) * 3);
+        quint32 *idx = fill->indices.data();
+        for (int i = 1; i < n - 1; ++i) {
+            *idx++ = 0;
+            *idx++ = i;
+            *idx++ = i + 1;
+        }
+    } else if (n > MAX_EAR_CLIP_VERTICES || !earClip(poly, &fill->indices)) {
+        fill->indices.clear();
+        return false;
+    }
+
+    fill->vertices.resize(n);
+    ColoredVertex *vdst = reinterpret_cast<ColoredVertex *>(fill->vertices.data());
+    for (int i = 0; i < n; ++i)
+        vdst[i].set(poly.at(i).x() / scale, poly.at(i).y() / scale, fillColor);
+    return true;
+}
+
+bool QQuickPathRenderer::isFillRuleIndependent(const QVectorPath &vp, qreal scale)
+{
+    QPolygonF poly;
+    if (!toSingleContour(vp, scale, &poly))
+        return false;
+    return isConvex(poly) || (poly.count() <= MAX_EAR_CLIP_VERTICES && isSimple(poly));
+}
+
+void QQuickPathRenderer::triangulateFill(const QVectorPath &vp,
+                                         const Color4ub &fillColor,
+                                         FillGeometry *fill,
+                                         bool supportsElementIndexUint,
+                                         bool antialiasing,
+                                         qreal scale)
+{
+    *fill = FillGeometry();
+    const qreal triScale = triangulationScale(scale);
+
+    if (antialiasing) {
+        // Only the boundary gets a fringe, edges inside the fill would be
+        // blended twice. Overlapping and self-intersecting contours are
+        // merged for that, simple ones are left alone.
+        QPainterPath path = vp.convertToPainterPath();
+        if (!isFillRuleIndependent(vp, triScale))
+            path = path.simplified();
+        appendFringe(path.toSubpathPolygons(QTransform::fromScale(triScale, triScale)), path.fillRule(),
+                     triScale, fillColor, &fill->fringe);
+    }
+
+    if (triangulateSimpleFill(vp, triScale, fillColor, fill))
+        return;
+
+    QTriangleSet ts = qTriangulate(vp, QTransform::fromScale(triScale, triScale));
+    const int vertexCount = ts.vertices.count() / 2;
+    if (vertexCount <= MAX_USHORT_VERTICES) {
+        appendTriangleSet(ts, triScale, fillColor, fill);
+        fill->ranges.clear();
+        return;
+    }
+
+    if (ts.indices.type() == QVertexIndexVector::UnsignedInt && supportsElementIndexUint) {
+        appendTriangleSet(ts, triScale, fillColor, fill);
+        fill->ranges.clear();
+        fill->indexType = QSGGeometry::UnsignedIntType;
+        return;
+    }
+
+    triangulateFillInBands(vp.convertToPainterPath(), vertexCount, triScale, fillColor, fill);
+
+    if (supportsElementIndexUint) {
+        // merge the bands into one mesh
+        for (const FillRange &range : qAsConst(fill->ranges)) {
+            quint32 *idx = fill->indices.data() + range.indexStart;
+            for (int i = 0; i < range.indexCount; ++i)
+                idx[i] += range.vertexStart;
+        }
+        fill->ranges.clear();
+        fill->indexType = QSGGeometry::UnsignedIntType;
+    }
+}
+
+// A subpath's elements [start, end) and the bounds of its control points.
+struct QQuickPathSubpath
+{
+    int start;
+    int end;
+    QRectF bounds;
+};
+
+static int findPieceRoot(QVector<int> *parent, int i)
+{
+    int *p = parent->data();
+    while (p[i] != i) {
+        p[i] = p[p[i]];
+        i = p[i];
+    }
+    return i;
+}
+
+// Appends the elements [start, end) of src to dst.
+static void appendElements(const QPainterPath &src, int start, int end, QPainterPath *dst)
+{
+    for (int i = start; i < end; ++i) {
+        const QPainterPath::Element &e = src.elementAt(i);
+        switch (e.type) {
+        case QPainterPath::MoveToElement:
+            dst->moveTo(e);
+            break;
+        case QPainterPath::LineToElement:
+            dst->lineTo(e);
+            break;
+        case QPainterPath::CurveToElement:
+            dst->cubicTo(e, src.elementAt(i + 1), src.elementAt(i + 2));
+            i += 2;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+// Groups the subpaths whose bounds overlap, directly or through others, into
+// one piece each, in the order of their first subpath. Subpaths that cannot
+// enclose any area are dropped. touched tells for each piece if it has
+// elements in [changedFirst, changedLast].
+static QQuickPathRenderer::FillPieceContainer splitIntoPieces(const QPainterPath &path, qreal margin,
+                                                             int changedFirst, int changedLast,
+                                                             QVector<bool> *touched)
+{
+    QVector<QQuickPathSubpath> subpaths;
+    const int elementCount = path.elementCount();
+    for (int i = 0; i < elementCount; ) {
+        QQuickPathSubpath sp;
+        sp.start = i;
+        qreal x0 = path.elementAt(i).x;
+        qreal y0 = path.elementAt(i).y;
+        qreal x1 = x0;
+        qreal y1 = y0;
+        for (++i; i < elementCount && !path.elementAt(i).isMoveTo(); ++i) {
+            const QPainterPath::Element &e = path.elementAt(i);
+            x0 = qMin(x0, e.x);
+            y0 = qMin(y0, e.y);
+            x1 = qMax(x1, e.x);
+            y1 = qMax(y1, e.y);
+        }
+        sp.end = i;
+        sp.bounds = QRectF(QPointF(x0, y0), QPointF(x1, y1)).adjusted(-margin, -margin, margin, margin);
+        if (sp.end - sp.start >= 3)
+            subpaths.append(sp);
+    }
+
+    // Sweep from left to right, comparing each subpath with the ones that
+    // are still open at its left edge.
+    const int n = subpaths.count();
+    QVector<int> order(n);
+    QVector<int> parent(n);
+    for (int i = 0; i < n; ++i)
+        order[i] = parent[i] = i;
+    std::sort(order.begin(), order.end(), [&subpaths](int a, int b) {
+        return subpaths.at(a).bounds.left() < subpaths.at(b).bounds.left();
+    });
+    QVector<int> open;
+    for (int i : qAsConst(order)) {
+        const QRectF &r(subpaths.at(i).bounds);
+        int k = 0;
+        for (int j : qAsConst(open)) {
+            const QRectF &o(subpaths.at(j).bounds);
+            if (o.right() < r.left())
+                continue;
+            open[k++] = j;
+            if (o.top() <= r.bottom() && o.bottom() >= r.top()) {
+                const int root = findPieceRoot(&parent, j);
+                parent[root] = findPieceRoot(&parent, i);
+            }
+        }
+        open.resize(k);
+        open.append(i);
+    }
+
+    QQuickPathRenderer::FillPieceContainer pieces;
+    QVector<int> pieceIndex(n, -1);
+    for (int i = 0; i < n; ++i) {
+        const QQuickPathSubpath &sp(subpaths.at(i));
+        const int root = findPieceRoot(&parent, i);
+        if (pieceIndex[root] < 0) {
+            pieceIndex[root] = pieces.count();
+            pieces.append(QQuickPathRenderer::FillPiece());
+            pieces.last().path.setFillRule(path.fillRule());
+            touched->append(false);
+        }
+        QQuickPathRenderer::FillPiece &piece(pieces[pieceIndex[root]]);
+        appendElements(path, sp.start, sp.end, &piece.path);
+        piece.subpaths.append(sp.start);
+        if (sp.start <= changedLast && sp.end > changedFirst)
+            (*touched)[pieceIndex[root]] = true;
+    }
+    return pieces;
+}
+
+static inline bool sameColor(const QQuickPathRenderer::Color4ub &a, const QQuickPathRenderer::Color4ub &b)
+{
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+// Reused pieces may have been triangulated with an outdated color. The nodes
+// only check the first vertex when uploading, so the merged geometry must not
+// have mixed colors.
+static void recolorFillGeometry(QQuickPathRenderer::FillGeometry *fill, const QQuickPathRenderer::Color4ub &color)
+{
+    ColoredVertex *v = reinterpret_cast<ColoredVertex *>(fill->vertices.data());
+    for (int i = 0; i < fill->vertices.count(); ++i)
+        v[i].color = color;
+    for (QQuickPathRenderer::SmoothColoredPoint2D &f : fill->fringe) {
+        if (f.dx == 0 && f.dy == 0) {
+            f.r = color.r;
+            f.g = color.g;
+            f.b = color.b;
+            f.a = color.a;
+        }
+    }
+}
+
+// Concatenates the pieces' geometry into one mesh. As in triangulateFill(),
+// the result is only split into ranges when it does not fit 16-bit indices
+// and 32-bit ones are not supported.
+static void mergeFillPieces(const QQuickPathRenderer::FillPieceContainer &pieces, bool otherFill,
+                            bool supportsElementIndexUint, QQuickPathRenderer::FillGeometry *fill)
+{
+    typedef QQuickPathRenderer::FillGeometry FillGeometry;
+    typedef QQuickPathRenderer::FillRange FillRange;
+
+    *fill = FillGeometry();
+    int vertexCount = 0;
+    int indexCount = 0;
+    for (const QQuickPathRenderer::FillPiece &piece : pieces) {
+        const FillGeometry &g(otherFill ? piece.otherFill : piece.fill);
+        vertexCount += g.vertices.count();
+        indexCount += g.indices.count();
+    }
+    fill->vertices.reserve(vertexCount);
+    fill->indices.reserve(indexCount);
+
+    for (const QQuickPathRenderer::FillPiece &piece : pieces) {
+        const FillGeometry &g(otherFill ? piece.otherFill : piece.fill);
+
+        if (!g.fringe.isEmpty()) {
+            // connect to the previous piece with degenerate triangles
+            if (!fill->fringe.isEmpty()) {
+                fill->fringe.append(fill->fringe.last());
+                fill->fringe.append(g.fringe.first());
+            }
+            fill->fringe += g.fringe;
+        }
+
+        // pack the pieces' ranges into as few 16-bit addressable ones as possible
+        const FillRange whole = { 0, g.vertices.count(), 0, g.indices.count() };
+        const int rangeCount = qMax(1, g.ranges.count());
+        for (int r = 0; r < rangeCount; ++r) {
+            const FillRange &src(g.ranges.isEmpty() ? whole : g.ranges.at(r));
+            if (!src.vertexCount)
+                continue;
+            if (fill->ranges.isEmpty() || fill->ranges.last().vertexCount + src.vertexCount > MAX_USHORT_VERTICES) {
+                const FillRange range = { fill->vertices.count(), 0, fill->indices.count(), 0 };
+                fill->ranges.append(range);
+            }
+            FillRange &dst(fill->ranges.last());
+
+            const int vertexStart = fill->vertices.count();
+            fill->vertices.resize(vertexStart + src.vertexCount);
+            memcpy(fill->vertices.data() + vertexStart, g.vertices.constData() + src.vertexStart,
+                   src.vertexCount * sizeof(QSGGeometry::ColoredPoint2D));
+
+            const int indexStart = fill->indices.count();
+            fill->indices.resize(indexStart + src.indexCount);
+            const quint32 *isrc = g.indices.constData() + src.indexStart;
+            quint32 *idst = fill->indices.data() + indexStart;
+            for (int i = 0; i < src.indexCount; ++i)
+                idst[i] = isrc[i] + dst.vertexCount;
+
+            dst.vertexCount += src.vertexCount;
+            dst.indexCount += src.indexCount;
+        }
+    }
+
+    if (fill->ranges.count() > 1 && supportsElementIndexUint) {
+        for (const FillRange &range : qAsConst(fill->ranges)) {
+            quint32 *idx = fill->indices.data() + range.indexStart;
+            for (int i = 0; i < range.indexCount; ++i)
+                idx[i] += range.vertexStart;
+        }
+        fill->ranges.clear();
+    } else if (fill->ranges.count() == 1) {
+        fill->ranges.clear();
+    }
+    if (fill->ranges.isEmpty() && fill->vertices.count() > MAX_USHORT_VERTICES)
+        fill->indexType = QSGGeometry::UnsignedIntType;
+}
+
+// Takes over the geometry of a previous piece.
+static void reuseFillPiece(const QQuickPathRenderer::FillPiece &from, const QQuickPathRenderer::Color4ub &fillColor,
+                           QQuickPathRenderer::FillPiece *piece)
+{
+    piece->fill = from.fill;
+    piece->otherFill = from.otherFill;
+    if (!piece->fill.vertices.isEmpty()
+            && !sameColor(reinterpret_cast<const ColoredVertex *>(piece->fill.vertices.constData())->color, fillColor)) {
+        recolorFillGeometry(&piece->fill, fillColor);
+        recolorFillGeometry(&piece->otherFill, fillColor);
+    }
+}
+
+bool QQuickPathRenderer::triangulateFillPieces(const QPainterPath &path,
+                                               const Color4ub &fillColor,
+                                               const FillPieceContainer &previous,
+                                               FillPieceContainer *pieces,
+                                               FillGeometry *fill,
+                                               FillGeometry *otherFill,
+                                               bool supportsElementIndexUint,
+                                               bool antialiasing,
+                                               qreal scale,
+                                               int changedFirst,
+                                               int changedLast)
+{
+    // The bounds are grown by a unit of the triangulator's space so that the
+    // pieces cannot touch after rounding. Without a known change, every piece
+    // counts as touched.
+    QVector<bool> touched;
+    FillPieceContainer result = splitIntoPieces(path, 1 / triangulationScale(scale),
+                                                changedFirst >= 0 ? changedFirst : 0,
+                                                changedFirst >= 0 ? changedLast : INT_MAX, &touched);
+    if (result.count() < 2) {
+        pieces->clear();
+        return false;
+    }
+
+    // The previous pieces may have been made before a fill rule change.
+    FillPieceContainer candidates = previous;
+    if (otherFill && !candidates.isEmpty() && candidates.first().path.fillRule() != path.fillRule()) {
+        for (FillPiece &piece : candidates) {
+            piece.path.setFillRule(path.fillRule());
+            qSwap(piece.fill, piece.otherFill);
+        }
+    }
+    QVector<bool> candidateUsed(candidates.count(), false);
+    QVector<bool> done(result.count(), false);
+
+    // Untouched pieces have the same elements as before when they consist of
+    // the same subpaths.
+    if (changedFirst >= 0) {
+        QHash<int, int> candidateIndex;
+        candidateIndex.reserve(candidates.count());
+        for (int i = 0; i < candidates.count(); ++i)
+            candidateIndex.insert(candidates.at(i).subpaths.first(), i);
+        for (int i = 0; i < result.count(); ++i) {
+            if (touched.at(i))
+                continue;
+            const int j = candidateIndex.value(result.at(i).subpaths.first(), -1);
+            if (j >= 0 && candidates.at(j).subpaths == result.at(i).subpaths) {
+                reuseFillPiece(candidates.at(j), fillColor, &result[i]);
+                candidateUsed[j] = true;
+                done[i] = true;
+            }
+        }
+    }
+
+    // The rest is looked up by content, which also finds pieces that moved
+    // around in the path.
+    QHash<quint64, int> candidateIndex;
+    for (int i = 0; i < candidates.count(); ++i) {
+        if (!candidateUsed.at(i))
+            candidateIndex.insert(QQuickPathTriangulationCache::pathHash(candidates.at(i).path), i);
+    }
+    for (int i = 0; i < result.count(); ++i) {
+        if (done.at(i))
+            continue;
+        FillPiece &piece(result[i]);
+        const int j = candidateIndex.value(QQuickPathTriangulationCache::pathHash(piece.path), -1);
+        if (j >= 0 && candidates.at(j).path == piece.path)
+            reuseFillPiece(candidates.at(j), fillColor, &piece);
+        else
+            triangulateFillRules(piece.path, fillColor, &piece.fill, otherFill ? &piece.otherFill : nullptr,
+                                 supportsElementIndexUint, antialiasing, false, scale);
+    }
+
+    mergeFillPieces(result, false, supportsElementIndexUint, fill);
+    if (otherFill)
+        mergeFillPieces(result, true, supportsElementIndexUint, otherFill);
+    *pieces = result;
+    return true;
+}
+
+const QSGGeometry::AttributeSet &QQuickPathRenderer::curveColoredAttributes()
+{
+    static QSGGeometry::Attribute data[] = {
+        QSGGeometry::Attribute::create(0, 2, QSGGeometry::FloatType, true),
+        QSGGeometry::Attribute::create(1, 4, QSGGeometry::UnsignedByteType, false),
+        QSGGeometry::Attribute::create(2, 3, QSGGeometry::FloatType, false)
+    };
+    static QSGGeometry::AttributeSet attrs = { 3, sizeof(CurveColoredPoint2D), data };
+    return attrs;
+}
+
+// the most quadratics a cubic gets split into
+static const int MAX_CUBIC_SPLITS = 32;
+
+// Approximates the cubic with quadratics so that they stay within tolerance,
+// appending (control, end) pairs. The error of the midpoint approximation
+// for a piece of 1/n of the parameter range is sqrt(3)/36 * |p3 - 3c2 + 3c1 - p0| / n^3.
+static void cubicToQuadratics(const QBezier &b, qreal tolerance, QVector<QPointF> *quads)
+{
+    const QPointF d = b.pt4() - 3 * b.pt3() + 3 * b.pt2() - b.pt1();
+    const qreal err = 0.0481125 * qSqrt(d.x() * d.x() + d.y() * d.y());
+    const int n = qBound(1, qCeil(qPow(err / tolerance, 1.0 / 3)), MAX_CUBIC_SPLITS);
+    for (int i = 0; i < n; ++i) {
+        const QBezier sub = b.getSubRange(qreal(i) / n, qreal(i + 1) / n);
+        quads->append((3 * (sub.pt2() + sub.pt3()) - sub.pt1() - sub.pt4()) / 4);
+        quads->append(sub.pt4());
+    }
+}
+
+bool QQuickPathRenderer::triangulateCurveFill(const QVectorPath &vp,
+                                              const Color4ub &fillColor,
+                                              FillGeometry *fill,
+                                              bool supportsElementIndexUint,
+                                              qreal scale)
+{
+    *fill = FillGeometry();
+    const qreal tolerance = 0.5 / triangulationScale(scale);
+
+    // Build the control polygons. Each contour is a start point followed by
+    // (control, end) pairs, lines have the control point in the middle.
+    const QPainterPath path = vp.convertToPainterPath();
+    QVector<QVector<QPointF> > segments;
+    QVector<QPolygonF> contours;
+    QVector<QRectF> bounds;
+    QVector<QPointF> current;
+    auto closeContour = [&]() {
+        if (current.count() >= 3) {
+            QPolygonF c(current);
+            segments.append(current);
+            contours.append(c);
+            bounds.append(c.boundingRect());
+        }
+        current.clear();
+    };
+    for (int i = 0; i < path.elementCount(); ++i) {
+        const QPainterPath::Element &e = path.elementAt(i);
+        switch (e.type) {
+        case QPainterPath::MoveToElement:
+            closeContour();
+            current.append(e);
+            break;
+        case QPainterPath::LineToElement:
+            if (current.isEmpty())
+                current.append(QPointF());
+            current.append((current.last() + QPointF(e)) / 2);
+            current.append(e);
+            break;
+        case QPainterPath::CurveToElement:
+        {
+            if (current.isEmpty())
+                current.append(QPointF());
+            const QBezier b = QBezier::fromPoints(current.last(), e, path.elementAt(i + 1), path.elementAt(i + 2));
+            cubicToQuadratics(b, tolerance, &current);
+            i += 2;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    closeContour();
+
+    // The interior goes through the control point of the segments bending
+    // inwards and along the chord of the others. The curve triangle covers
+    // the rest.
+    struct CurveTriangle { QPointF p0, c, p1; float side; };
+    QVector<CurveTriangle> curves;
+    QPainterPath interior;
+    interior.setFillRule(vp.hasWindingFill() ? Qt::WindingFill : Qt::OddEvenFill);
+    for (int ci = 0; ci < segments.count(); ++ci) {
+        const QVector<QPointF> &seg(segments.at(ci));
+        const bool inside = rightIsInside(contours, bounds, ci, interior.fillRule());
+        interior.moveTo(seg.first());
+        for (int i = 1; i + 1 < seg.count(); i += 2) {
+            const QPointF &p0(seg.at(i - 1));
+            const QPointF &c(seg.at(i));
+            const QPointF &p1(seg.at(i + 1));
+            const QPointF chord = p1 - p0;
+            const qreal area = cross(chord, c - p0);
+            // flat enough to be a line, this includes the actual lines
+            if (qAbs(area) <= 1e-3 * tolerance * qSqrt(chord.x() * chord.x() + chord.y() * chord.y())) {
+                interior.lineTo(p1);
+                continue;
+            }
+            // c is to the right of p0->p1 when the cross product is negative
+            const bool concave = (area < 0) == inside;
+            if (concave)
+                interior.lineTo(c);
+            interior.lineTo(p1);
+            const CurveTriangle t = { p0, c, p1, concave ? -1.0f : 1.0f };
+            curves.append(t);
+        }
+        interior.closeSubpath();
+    }
+
+    FillGeometry hull;
+    triangulateFill(qtVectorPathForPath(interior), fillColor, &hull, supportsElementIndexUint, false, scale);
+    if (!hull.ranges.isEmpty())
+        return false;
+
+    const int hullVertexCount = hull.vertices.count();
+    const int vertexCount = hullVertexCount + curves.count() * 3;
+    fill->indexType = hull.indexType;
+    if (vertexCount > MAX_USHORT_VERTICES) {
+        if (!supportsElementIndexUint)
+            return false;
+        fill->indexType = QSGGeometry::UnsignedIntType;
+    }
+
+    fill->indices = hull.indices;
+    fill->curveVertices.resize(vertexCount);
+    CurveColoredPoint2D *vdst = fill->curveVertices.data();
+    for (const QSGGeometry::ColoredPoint2D &v : qAsConst(hull.vertices)) {
+        const CurveColoredPoint2D cv = { v.x, v.y, v.r, v.g, v.b, v.a, 0, 0, 0 };
+        *vdst++ = cv;
+    }
+    fill->indices.reserve(fill->indices.count() + curves.count() * 3);
+    quint32 idx = hullVertexCount;
+    for (const CurveTriangle &t : qAsConst(curves)) {
+        const Color4ub &c(fillColor);
+        const CurveColoredPoint2D v0 = { float(t.p0.x()), float(t.p0.y()), c.r, c.g, c.b, c.a, 0, 0, t.side };
+        const CurveColoredPoint2D v1 = { float(t.c.x()), float(t.c.y()), c.r, c.g, c.b, c.a, 0.5f, 0, t.side };
+        const CurveColoredPoint2D v2 = { float(t.p1.x()), float(t.p1.y()), c.r, c.g, c.b, c.a, 1, 1, t.side };
+        *vdst++ = v0;
+        *vdst++ = v1;
+        *vdst++ = v2;
+        fill->indices << idx << idx + 1 << idx + 2;
+        idx += 3;
+    }
+    return true;
+}
+
+void QQuickPathRenderer::triangulateStroke(const QVectorPath &vp,
+                                           const QPen &pen,
+                                           const Color4ub &strokeColor,
+                                           VertexContainer *strokeVertices,
+                                           const QSizeF &clipSize,
+                                           FringeContainer *strokeFringe,
+                                           qreal scale)
+{
+    const QRectF clip(QPointF(0, 0), clipSize);
+    const qreal triScale = triangulationScale(scale);
+    const qreal inverseScale = 1.0 / triScale;
+
+    // Cosmetic strokes are left out, their width is in device pixels and so
+    // the outline cannot be calculated here.
+    if (strokeFringe) {
+        strokeFringe->clear();
+        if (!pen.isCosmetic() && !qFuzzyIsNull(pen.widthF())) {
+            QPainterPathStroker outliner(pen);
+            // the stroker's outline overlaps itself at joins and crossings,
+            // only its boundary gets a fringe
+            const QPainterPath outline = outliner.createStroke(vp.convertToPainterPath()).simplified();
+            appendFringe(outline.toSubpathPolygons(QTransform::fromScale(triScale, triScale)), Qt::WindingFill,
+                         triScale, strokeColor, strokeFringe);
+        }
+    }
+
+    QTriangulatingStroker stroker;
+    stroker.setInvScale(inverseScale);
+
+    if (pen.style() == Qt::SolidLine) {
+        stroker.process(vp, pen, clip, 0);
+    } else {
+        QDashedStrokeProcessor dashStroker;
+        dashStroker.setInvScale(inverseScale);
+        dashStroker.process(vp, pen, clip, 0);
+        QVectorPath dashStroke(dashStroker.points(), dashStroker.elementCount(),
+                               dashStroker.elementTypes(), 0);
+        stroker.process(dashStroke, pen, clip, 0);
+    }
+
+    if (!stroker.vertexCount()) {
+        strokeVertices->clear();
+        return;
+    }
+
+    const int vertexCount = stroker.vertexCount() / 2; // just a float vector with x,y hence the / 2
+    strokeVertices->resize(vertexCount);
+    ColoredVertex *vdst = reinterpret_cast<ColoredVertex *>(strokeVertices->data());
+    const float *vsrc = stroker.vertices();
+    for (int i = 0; i < vertexCount; ++i)
+        vdst[i].set(vsrc[i * 2], vsrc[i * 2 + 1], strokeColor);
+}
+
+// Above this the pairwise overlap test gets too expensive.
+static const int MAX_PRIMITIVES = 64;
+
+// Turns sharper than this get a join, the rest is treated as a smooth curve.
+static const qreal SMOOTH_TURN_COS = 0.996; // ~5 degrees
+
+static int arcSegmentCount(qreal radius, qreal sweep, qreal scale)
+{
+    const qreal r = radius * scale;
+    if (r <= CURVE_TOLERANCE)
+        return 1;
+    const qreal step = 2 * qAcos(1 - CURVE_TOLERANCE / r);
+    return qBound(1, qCeil(qAbs(sweep) / step), 1024);
+}
+
+static void appendArc(QPolygonF *poly, const QPointF &center, qreal rx, qreal ry,
+                      qreal startAngle, qreal sweep, qreal scale)
+{
+    const int n = arcSegmentCount(qMax(rx, ry), sweep, scale);
+    for (int i = 0; i <= n; ++i) {
+        const qreal a = startAngle + sweep * i / n;
+        poly->append(center + QPointF(rx * qCos(a), ry * qSin(a)));
+    }
+}
+
+// The outline of the shape as a convex polygon, going clockwise on screen.
+// Returns false for shapes with no area.
+static bool primitiveOutline(const QQuickPathPrimitive &p, qreal scale, QPolygonF *poly)
+{
+    const QRectF r = p.rect.normalized();
+    if (r.isEmpty())
+        return false;
+
+    poly->clear();
+    if (p.type == QQuickPathPrimitive::Ellipse) {
+        appendArc(poly, r.center(), r.width() / 2, r.height() / 2, 0, 2 * M_PI, scale);
+    } else {
+        // like QPainterPath::addRoundedRect()
+        const qreal rx = qMin(p.radiusX, r.width() / 2);
+        const qreal ry = qMin(p.radiusY, r.height() / 2);
+        if (p.type == QQuickPathPrimitive::RoundedRectangle && rx > 0 && ry > 0) {
+            appendArc(poly, QPointF(r.left() + rx, r.top() + ry), rx, ry, M_PI, M_PI / 2, scale);
+            appendArc(poly, QPointF(r.right() - rx, r.top() + ry), rx, ry, 1.5 * M_PI, M_PI / 2, scale);
+            appendArc(poly, QPointF(r.right() - rx, r.bottom() - ry), rx, ry, 0, M_PI / 2, scale);
+            appendArc(poly, QPointF(r.left() + rx, r.bottom() - ry), rx, ry, M_PI / 2, M_PI / 2, scale);
+        } else {
+            *poly << r.topLeft() << r.topRight() << r.bottomRight() << r.bottomLeft();
+        }
+    }
+
+    // Arcs meet where the radius is half the size, drop the (nearly)
+    // duplicate points there as the edges in between have no direction.
+    const qreal eps = qMax(r.width(), r.height()) * 1e-9;
+    QPointF *d = poly->data();
+    int n = 0;
+    for (int i = 0; i < poly->count(); ++i) {
+        if (n == 0 || (d[i] - d[n - 1]).manhattanLength() > eps)
+            d[n++] = d[i];
+    }
+    while (n > 1 && (d[n - 1] - d[0]).manhattanLength() <= eps)
+        --n;
+    poly->resize(n);
+    return n >= 3;
+}
+
+// The smallest radius of curvature along the outline. The inner side of a
+// stroke folds over itself when it is wider than this.
+static qreal primitiveMinCurvature(const QQuickPathPrimitive &p)
+{
+    const QRectF r = p.rect.normalized();
+    qreal rx = r.width() / 2;
+    qreal ry = r.height() / 2;
+    qreal limit = qMin(rx, ry);
+    if (p.type == QQuickPathPrimitive::RoundedRectangle) {
+        rx = qMin(p.radiusX, rx);
+        ry = qMin(p.radiusY, ry);
+        if (rx <= 0 || ry <= 0)
+            return limit;
+    } else if (p.type == QQuickPathPrimitive::Rectangle) {
+        return limit;
+    }
+    return qMin(limit, qMin(rx, ry) * qMin(rx, ry) / qMax(rx, ry));
+}
+
+bool QQuickPathRenderer::generatePrimitiveFill(const QVector<QQuickPathPrimitive> &primitives,
+                                               const Color4ub &fillColor,
+                                               qreal scale,
+                                               FillGeometry *fill,
+                                               bool antialiasing)
+{
+    // Overlapping shapes need the fill rule applied, leave that to the triangulator.
+    if (primitives.count() > MAX_PRIMITIVES)
+        return false;
+    for (int i = 0; i < primitives.count(); ++i) {
+        for (int j = i + 1; j < primitives.count(); ++j) {
+            if (primitives.at(i).rect.normalized().intersects(primitives.at(j).rect.normalized()))
+                return false;
+        }
+    }
+
+    *fill = FillGeometry();
+    QList<QPolygonF> outlines;
+    QPolygonF poly;
+    for (const QQuickPathPrimitive &p : primitives) {
+        if (!primitiveOutline(p, scale, &poly))
+            continue;
+        const int base = fill->vertices.count();
+        const int n = poly.count();
+        if (base + n > MAX_USHORT_VERTICES) {
+            *fill = FillGeometry();
+            return false;
+        }
+        fill->vertices.resize(base + n);
+        ColoredVertex *vdst = reinterpret_cast<ColoredVertex *>(fill->vertices.data()) + base;
+        for (int i = 0; i < n; ++i)
+            vdst[i].set(poly.at(i).x(), poly.at(i).y(), fillColor);
+        for (int i = 1; i < n - 1; ++i)
+            fill->indices << base << base + i << base + i + 1;
+        if (antialiasing)
+            outlines.append(poly);
+    }
+
+    if (antialiasing)
+        appendFringe(outlines, Qt::WindingFill, 1, fillColor, &fill->fringe);
+
+    return true;
+}
+
+bool QQuickPathRenderer::generatePrimitiveStroke(const QVector<QQuickPathPrimitive> &primitives,
+                                                 const QPen &pen,
+                                                 const Color4ub &strokeColor,
+                                                 qreal scale,
+                                                 VertexContainer *strokeVertices,
+                                                 FringeContainer *strokeFringe)
+{
+    if (pen.style() != Qt::SolidLine || pen.isCosmetic())
+        return false;
+
+    const qreal hw = pen.widthF() / 2;
+    for (const QQuickPathPrimitive &p : primitives) {
+        const QRectF r = p.rect.normalized();
+        // zero sized shapes still get stroked as lines, leave that to the stroker
+        if (r.isEmpty() || hw > primitiveMinCurvature(p))
+            return false;
+    }
+
+    strokeVertices->clear();
+    QList<QPolygonF> outlines;
+    QPolygonF poly;
+    for (const QQuickPathPrimitive &p : primitives) {
+        primitiveOutline(p, scale, &poly);
+        const int n = poly.count();
+        if (n < 3)
+            continue;
+
+        // a triangle strip of (outer, inner) pairs, linked to the previous
+        // shape with degenerate triangles
+        const bool link = !strokeVertices->isEmpty();
+        QPolygonF outer;
+        QPolygonF inner;
+        for (int j = 0; j <= n; ++j) {
+            const int i = j % n;
+            const QPointF &pt(poly.at(i));
+            const QPointF e0 = pt - poly.at((i + n - 1) % n);
+            const QPointF e1 = poly.at((i + 1) % n) - pt;
+            const QPointF n0 = QPointF(e0.y(), -e0.x()) / qSqrt(e0.x() * e0.x() + e0.y() * e0.y());
+            const QPointF n1 = QPointF(e1.y(), -e1.x()) / qSqrt(e1.x() * e1.x() + e1.y() * e1.y());
+            QPointF m = n0 + n1;
+            m /= qSqrt(m.x() * m.x() + m.y() * m.y()); // cannot be 0 for a convex polygon
+            const qreal cosHalf = m.x() * n0.x() + m.y() * n0.y();
+            const QPointF in = pt - m * (hw / cosHalf);
+
+            if (j == n) {
+                // close the strip where it started
+                strokeVertices->resize(strokeVertices->count() + 2);
+                ColoredVertex *v = reinterpret_cast<ColoredVertex *>(strokeVertices->data()) + strokeVertices->count() - 2;
+                v[0].set(outer.first().x(), outer.first().y(), strokeColor);
+                v[1].set(in.x(), in.y(), strokeColor);
+                break;
+            }
+
+            const int outerStart = outer.count();
+            if (cosHalf > SMOOTH_TURN_COS
+                    || (pen.joinStyle() == Qt::MiterJoin && 1 / cosHalf <= pen.miterLimit())) {
+                outer.append(pt + m * (hw / cosHalf));
+            } else if (pen.joinStyle() == Qt::RoundJoin) {
+                const qreal a0 = qAtan2(n0.y(), n0.x());
+                const qreal sweep = qAtan2(n0.x() * n1.y() - n0.y() * n1.x(), n0.x() * n1.x() + n0.y() * n1.y());
+                appendArc(&outer, pt, hw, hw, a0, sweep, scale);
+            } else {
+                outer.append(pt + n0 * hw);
+                outer.append(pt + n1 * hw);
+            }
+            inner.append(in);
+
+            const int pairCount = outer.count() - outerStart;
+            const int base = strokeVertices->count();
+            const int extra = j == 0 && link ? 2 : 0;
+            strokeVertices->resize(base + extra + pairCount * 2);
+            ColoredVertex *v = reinterpret_cast<ColoredVertex *>(strokeVertices->data()) + base;
+            if (extra) {
+                v[0] = v[-1];
+                v[1].set(outer.at(outerStart).x(), outer.at(outerStart).y(), strokeColor);
+                v += 2;
+            }
+            for (int k = 0; k < pairCount; ++k) {
+                const QPointF &o(outer.at(outerStart + k));
+                v[k * 2].set(o.x(), o.y(), strokeColor);
+                v[k * 2 + 1].set(in.x(), in.y(), strokeColor);
+            }
+        }
+
+        if (strokeFringe)
+            outlines << outer << inner;
+    }
+
+    if (strokeFringe) {
+        strokeFringe->clear();
+        // odd-even, the inner outline is a hole
+        appendFringe(outlines, Qt::OddEvenFill, 1, strokeColor, strokeFringe);
+    }
+
+    return true;
+}
+
+const QSGGeometry::AttributeSet &QQuickPathRenderer::extrudedColoredAttributes()
+{
+    static QSGGeometry::Attribute data[] = {
+        QSGGeometry::Attribute::create(0, 2, QSGGeometry::FloatType, true),
+        QSGGeometry::Attribute::create(1, 4, QSGGeometry::UnsignedByteType, false),
+        QSGGeometry::Attribute::create(2, 3, QSGGeometry::FloatType, false),
+        QSGGeometry::Attribute::create(3, 2, QSGGeometry::FloatType, false)
+    };
+    static QSGGeometry::AttributeSet attrs = { 4, sizeof(ExtrudedColoredPoint2D), data };
+    return attrs;
+}
+
+quint64 QQuickPathRenderer::gradientStopsHash(const QGradientStops &stops)
+{
+    quint64 h = QQuickPathTriangulationCache::hashSeed();
+    QQuickPathTriangulationCache::hashWord(&h, stops.count());
+    for (const QGradientStop &stop : stops) {
+        QQuickPathTriangulationCache::hashReal(&h, stop.first);
+        QQuickPathTriangulationCache::hashWord(&h, stop.second.rgba64());
+    }
+    return h;
+}
+
+void QQuickPathRenderer::updateGradientTable(GradientTable *table, const QGradientStops &stops)
+{
+    if (!table->texels.isEmpty() && table->stops == stops)
+        return;
+    table->stops = stops;
+    table->hash = gradientStopsHash(stops);
+    table->texels.resize(GradientTableWidth);
+    uint *texels = table->texels.data();
+    if (stops.isEmpty())
+        memset(texels, 0, GradientTableWidth * sizeof(uint));
+    else
+        generateGradientColorTable(stops, texels, GradientTableWidth, 1.0f);
+}
+
+// Fills dst with count colors between from and to. dist is the weight of to
+// for the first color and step its increment, both in 16.16 fixed point of
+// the 0..256 range INTERPOLATE_PIXEL_256 takes. The SSE2 path gives the same
+// results as the plain one.
+static void interpolateColors(uint *dst, int count, uint from, uint to, int dist, int step)
+{
+    int i = 0;
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i from16 = _mm_unpacklo_epi8(_mm_set1_epi32(from), zero);
+    const __m128i to16 = _mm_unpacklo_epi8(_mm_set1_epi32(to), zero);
+    const __m128i max = _mm_set1_epi16(256);
+    const __m128i step4 = _mm_set1_epi32(step * 4);
+    __m128i d = _mm_add_epi32(_mm_set1_epi32(dist), _mm_setr_epi32(0, step, step * 2, step * 3));
+    for (; i + 4 <= count; i += 4) {
+        // the weights of the four texels, each repeated for the channels
+        const __m128i w32 = _mm_srai_epi32(d, 16);
+        __m128i w = _mm_packs_epi32(w32, w32);
+        w = _mm_max_epi16(_mm_min_epi16(w, max), zero);
+        w = _mm_unpacklo_epi16(w, w);
+        const __m128i w01 = _mm_unpacklo_epi32(w, w);
+        const __m128i w23 = _mm_unpackhi_epi32(w, w);
+        const __m128i c01 = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(from16, _mm_sub_epi16(max, w01)),
+                                                         _mm_mullo_epi16(to16, w01)), 8);
+        const __m128i c23 = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(from16, _mm_sub_epi16(max, w23)),
+                                                         _mm_mullo_epi16(to16, w23)), 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(c01, c23));
+        d = _mm_add_epi32(d, step4);
+    }
+    dist += i * step;
+#endif
+    for (; i < count; ++i) {
+        const int w = qBound(0, dist >> 16, 256);
+        dst[i] = INTERPOLATE_PIXEL_256(from, 256 - w, to, w);
+        dist += step;
+    }
+}
+
+// Texel i samples the gradient at (i + 0.5) / size. Colors are converted
+// before interpolating, the conversion only reorders the channels.
+void QQuickPathRenderer::generateGradientColorTable(const QGradientStops &s,
+                                                    uint *colorTable, int size, float opacity)
+{
+    Q_ASSERT(s.size() > 0);
+    const uint alpha = qRound(opacity * 256);
+    const qreal incr = 1.0 / qreal(size);
+
+    uint current_color = ARGB2RGBA(qPremultiply(ARGB_COMBINE_ALPHA(s[0].second.rgba(), alpha)));
+    int pos = 0;
+    // up to and including the first stop, and always the first texel
+    const int first = qBound(1, qFloor(s[0].first * size + 0.5), size);
+    for (; pos < first; ++pos)
+        colorTable[pos] = current_color;
+
+    const int sLast = s.size() - 1;
+    for (int i = 0; i < sLast && pos < size; ++i) {
+        const uint next_color = ARGB2RGBA(qPremultiply(ARGB_COMBINE_ALPHA(s[i + 1].second.rgba(), alpha)));
+        // the texels before the next stop
+        const int end = qBound(pos, qCeil(s[i + 1].first * size - 0.5), size);
+        if (end > pos) {
+            const qreal delta = 1 / (s[i + 1].first - s[i].first);
+            const qreal scale = 256 * 65536 * delta;
+            const qreal dist = ((pos + 0.5) * incr - s[i].first) * scale;
+            // segments shorter than a texel saturate right away
+            const qreal step = qMin(incr * scale, qreal(256 * 65536));
+            interpolateColors(colorTable + pos, end - pos, current_color, next_color,
+                              int(qBound(qreal(0), dist, qreal(256 * 65536))), int(step));
+            pos = end;
+        }
+        current_color = next_color;
+    }
+
+    const uint last_color = ARGB2RGBA(qPremultiply(ARGB_COMBINE_ALPHA(s[sLast].second.rgba(), alpha)));
+    for (; pos < size; ++pos)
+        colorTable[pos] = last_color;
+
+    colorTable[size - 1] = last_color;
+}
+
+const QSGGeometry::AttributeSet &QQuickPathRenderer::gradientAttributes()
+{
+    static QSGGeometry::Attribute data[] = {
+        QSGGeometry::Attribute::create(0, 2, QSGGeometry::FloatType, true),
+        QSGGeometry::Attribute::create(1, 3, QSGGeometry::FloatType, false)
+    };
+    static QSGGeometry::AttributeSet attrs = { 2, sizeof(GradientPoint2D), data };
+    return attrs;
+}
+
+// Round joins and caps are tessellated for at least this half width.
+static const qreal MIN_EXTRUDED_ARC_RADIUS = 4;
+
+// Emits a triangle strip of centerline points with offsets for a half width
+// of 1. Segments get a (left, right) pair at both ends, joins and caps are
+// fans around the centerline point, linked with degenerate triangles.
+class QQuickPathStrokeExtruder
+{
+public:
+    QQuickPathStrokeExtruder(const QPen &pen, const QQuickPathRenderer::Color4ub &color,
+                             qreal scale, QQuickPathRenderer::ExtrudedVertexContainer *vertices)
+        : m_pen(pen),
+          m_color(color),
+          m_arcScale(scale * qMax(pen.widthF() / 2, MIN_EXTRUDED_ARC_RADIUS)),
+          m_vertices(vertices),
+          m_length(0),
+          m_base(0),
+          m_totalLength(0),
+          m_link(false)
+    { }
+
+    // the length of all polylines, for the positions
+    void setTotalLength(qreal length) { m_totalLength = length; }
+    void addPolyline(QPolygonF poly);
+
+private:
+    void add(const QPointF &pt, const QPointF &offset, float side);
+    void pair(const QPointF &pt, const QPointF &normal)
+    {
+        add(pt, normal, 1);
+        add(pt, -normal, -1);
+    }
+    void fan(const QPointF &pt, const QPolygonF &rim);
+    void join(const QPointF &pt, const QPointF &n0, const QPointF &n1);
+    void cap(const QPointF &pt, const QPointF &normal, bool start);
+
+    QPen m_pen;
+    QQuickPathRenderer::Color4ub m_color;
+    qreal m_arcScale;
+    QQuickPathRenderer::ExtrudedVertexContainer *m_vertices;
+    qreal m_length; // along the current polyline
+    qreal m_base; // length of the previous polylines
+    qreal m_totalLength;
+    bool m_link;
+};
+
+void QQuickPathStrokeExtruder::add(const QPointF &pt, const QPointF &offset, float side)
+{
+    const QQuickPathRenderer::ExtrudedColoredPoint2D v = { float(pt.x()), float(pt.y()),
+                                                           m_color.r, m_color.g, m_color.b, m_color.a,
+                                                           float(offset.x()), float(offset.y()), side,
+                                                           float(m_length),
+                                                           float(m_totalLength > 0 ? (m_base + m_length) / m_totalLength : 0) };
+    if (m_link) {
+        m_link = false;
+        m_vertices->append(v);
+    }
+    m_vertices->append(v);
+}
+
+// alternates between the centerline point and the rim
+void QQuickPathStrokeExtruder::fan(const QPointF &pt, const QPolygonF &rim)
+{
+    for (const QPointF &offset : rim) {
+        add(pt, QPointF(), 0);
+        add(pt, offset, 1);
+    }
+}
+
+// Returns true when the turn is small enough to use a miter, giving its offset.
+static bool smoothJoin(const QPointF &n0, const QPointF &n1, QPointF *offset)
+{
+    const QPointF m = n0 + n1;
+    const qreal len = qSqrt(m.x() * m.x() + m.y() * m.y());
+    if (len < 1e-6)
+        return false;
+    const qreal cosHalf = (m.x() * n0.x() + m.y() * n0.y()) / len;
+    if (cosHalf <= SMOOTH_TURN_COS)
+        return false;
+    *offset = m / (len * cosHalf);
+    return true;
+}
+
+// n0 and n1 are the normals of the segments before and after pt. Ends the
+// previous segment, fills the gap on the outer side and starts the next one.
+void QQuickPathStrokeExtruder::join(const QPointF &pt, const QPointF &n0, const QPointF &n1)
+{
+    QPointF offset;
+    if (smoothJoin(n0, n1, &offset)) {
+        // flattened curves, share the pair between the segments
+        pair(pt, offset);
+        return;
+    }
+
+    const QPointF m = n0 + n1;
+    const qreal len = qSqrt(m.x() * m.x() + m.y() * m.y());
+    const qreal cosHalf = len < 1e-6 ? 0 : (m.x() * n0.x() + m.y() * n0.y()) / len;
+
+    pair(pt, n0);
+    // the outer side is the one the next segment turns away from
+    const qreal side = n0.x() * -n1.y() + n0.y() * n1.x() < 0 ? 1 : -1;
+    QPolygonF rim;
+    if (m_pen.joinStyle() == Qt::RoundJoin) {
+        const qreal sweep = qAtan2(n0.x() * n1.y() - n0.y() * n1.x(), n0.x() * n1.x() + n0.y() * n1.y());
+        appendArc(&rim, QPointF(), 1, 1, qAtan2(side * n0.y(), side * n0.x()), sweep, m_arcScale);
+    } else {
+        rim << n0 * side;
+        if ((m_pen.joinStyle() == Qt::MiterJoin || m_pen.joinStyle() == Qt::SvgMiterJoin)
+                && cosHalf > 0 && 1 / cosHalf <= m_pen.miterLimit()) {
+            rim << m * (side / (len * cosHalf));
+        }
+        rim << n1 * side;
+    }
+    fan(pt, rim);
+    pair(pt, n1);
+}
+
+void QQuickPathStrokeExtruder::cap(const QPointF &pt, const QPointF &normal, bool start)
+{
+    // the tangent pointing away from the line
+    const QPointF t = start ? QPointF(normal.y(), -normal.x()) : QPointF(-normal.y(), normal.x());
+    switch (m_pen.capStyle()) {
+    case Qt::SquareCap:
+        add(pt, normal + t, 1);
+        add(pt, -normal + t, -1);
+        break;
+    case Qt::RoundCap:
+    {
+        const QPointF from = start ? normal : -normal;
+        QPolygonF rim;
+        appendArc(&rim, QPointF(), 1, 1, qAtan2(from.y(), from.x()), -M_PI, m_arcScale);
+        fan(pt, rim);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void QQuickPathStrokeExtruder::addPolyline(QPolygonF poly)
+{
+    const bool closed = poly.count() > 2 && poly.first() == poly.last();
+    removeRepeatedPoints(&poly);
+    const int n = poly.count();
+    if (n < 2)
+        return;
+
+    const int segmentCount = closed ? n : n - 1;
+    QVector<QPointF> normals(segmentCount);
+    for (int i = 0; i < segmentCount; ++i) {
+        const QPointF e = poly.at((i + 1) % n) - poly.at(i);
+        normals[i] = QPointF(e.y(), -e.x()) / qSqrt(e.x() * e.x() + e.y() * e.y());
+    }
+
+    m_link = !m_vertices->isEmpty();
+    if (m_link)
+        m_vertices->append(m_vertices->last());
+
+    // the dash pattern starts over for each subpath
+    QVector<qreal> lengths(n + 1);
+    lengths[0] = 0;
+    for (int i = 1; i <= n; ++i) {
+        const QPointF e = poly.at(i % n) - poly.at(i - 1);
+        lengths[i] = lengths[i - 1] + qSqrt(e.x() * e.x() + e.y() * e.y());
+    }
+
+    m_length = 0;
+    if (closed) {
+        // start and end with the same pair when the first point is smooth,
+        // otherwise the join goes to the end
+        QPointF offset;
+        const bool smooth = smoothJoin(normals.at(n - 1), normals.at(0), &offset);
+        pair(poly.at(0), smooth ? offset : normals.at(0));
+        for (int i = 1; i < n; ++i) {
+            m_length = lengths.at(i);
+            join(poly.at(i), normals.at(i - 1), normals.at(i));
+        }
+        m_length = lengths.at(n);
+        if (smooth)
+            pair(poly.at(0), offset);
+        else
+            join(poly.at(0), normals.at(n - 1), normals.at(0));
+    } else {
+        cap(poly.at(0), normals.at(0), true);
+        pair(poly.at(0), normals.at(0));
+        for (int i = 1; i < n - 1; ++i) {
+            m_length = lengths.at(i);
+            join(poly.at(i), normals.at(i - 1), normals.at(i));
+        }
+        m_length = lengths.at(n - 1);
+        pair(poly.at(n - 1), normals.at(n - 2));
+        cap(poly.at(n - 1), normals.at(n - 2), false);
+    }
+    m_base += m_length;
+}
+
+static inline qreal lineLength(const QPointF &a, const QPointF &b)
+{
+    const QPointF e = b - a;
+    return qSqrt(e.x() * e.x() + e.y() * e.y());
+}
+
+// Returns the part of the path between start and end, given as fractions of
+// the total length. Subpaths are treated as one continuous path.
+QPainterPath QQuickPathRenderer::trimPath(const QPainterPath &path, qreal start, qreal end)
+{
+    if (start <= 0 && end >= 1)
+        return path;
+
+    QPainterPath result;
+    result.setFillRule(path.fillRule());
+    if (end <= start || path.isEmpty())
+        return result;
+
+    const int count = path.elementCount();
+    QVector<qreal> lengths(count, 0);
+    qreal total = 0;
+    for (int i = 1; i < count; ++i) {
+        const QPainterPath::Element &e = path.elementAt(i);
+        if (e.type == QPainterPath::LineToElement) {
+            lengths[i] = lineLength(path.elementAt(i - 1), e);
+        } else if (e.type == QPainterPath::CurveToElement) {
+            // stored at the last element of the curve
+            lengths[i + 2] = QBezier::fromPoints(path.elementAt(i - 1), e, path.elementAt(i + 1),
+                                                 path.elementAt(i + 2)).length();
+            i += 2;
+        }
+        total += lengths.at(i);
+    }
+
+    const qreal from = start * total;
+    const qreal to = end * total;
+    qreal pos = 0;
+    for (int i = 1; i < count && pos < to; ++i) {
+        const QPainterPath::Element &e = path.elementAt(i);
+        const bool curve = e.type == QPainterPath::CurveToElement;
+        const int last = curve ? i + 2 : i;
+        const qreal len = lengths.at(last);
+        if (e.type != QPainterPath::MoveToElement && pos + len > from && len > 0) {
+            const qreal t0 = qMax<qreal>(0, (from - pos) / len);
+            const qreal t1 = qMin<qreal>(1, (to - pos) / len);
+            const QPointF p0 = path.elementAt(i - 1);
+            if (curve) {
+                const QBezier b = QBezier::fromPoints(p0, e, path.elementAt(i + 1), path.elementAt(i + 2));
+                const qreal bt0 = t0 > 0 ? b.tAtLength(t0 * len) : 0;
+                const qreal bt1 = t1 < 1 ? b.tAtLength(t1 * len) : 1;
+                const QBezier sub = b.getSubRange(bt0, bt1);
+                if (result.isEmpty() || t0 > 0 || result.currentPosition() != sub.pt1())
+                    result.moveTo(sub.pt1());
+                result.cubicTo(sub.pt2(), sub.pt3(), sub.pt4());
+            } else {
+                const QPointF p1 = e;
+                const QPointF a = p0 + (p1 - p0) * t0;
+                if (result.isEmpty() || t0 > 0 || result.currentPosition() != a)
+                    result.moveTo(a);
+                result.lineTo(p0 + (p1 - p0) * t1);
+            }
+        } else if (e.type == QPainterPath::MoveToElement && !result.isEmpty()) {
+            result.moveTo(e);
+        }
+        pos += len;
+        i = last;
+    }
+    return result;
+}
+
+void QQuickPathRenderer::extrudeStroke(const QVectorPath &vp,
+                                       const QPen &pen,
+                                       const Color4ub &strokeColor,
+                                       ExtrudedVertexContainer *strokeVertices,
+                                       qreal scale)
+{
+    strokeVertices->clear();
+    // flatten in the same space as the fill so that the curves match
+    const qreal triScale = triangulationScale(scale);
+    const QList<QPolygonF> polys = vp.convertToPainterPath().toSubpathPolygons(QTransform::fromScale(triScale, triScale));
+    QQuickPathStrokeExtruder extruder(pen, strokeColor, scale, strokeVertices);
+    qreal totalLength = 0;
+    for (const QPolygonF &poly : polys) {
+        for (int i = 1; i < poly.count(); ++i) {
+            const QPointF e = poly.at(i) - poly.at(i - 1);
+            totalLength += qSqrt(e.x() * e.x() + e.y() * e.y());
+        }
+    }
+    extruder.setTotalLength(totalLength / triScale);
+    for (QPolygonF poly : polys) {
+        for (QPointF &pt : poly)
+            pt /= triScale;
+        extruder.addPolyline(poly);
+    }
+}
+
+void QQuickPathRenderer::updatePathRenderNode()
+{
+    if (!m_renderDirty || !m_rootNode)
+        return;
+
+    if (m_fillColor.a == 0) {
+        qDeleteAll(m_rootNode->m_extraFillNodes);
+        m_rootNode->m_extraFillNodes.clear();
+        delete m_rootNode->m_fillNode;
+        m_rootNode->m_fillNode = nullptr;
+    } else if (!m_rootNode->m_fillNode) {
+        m_rootNode->m_fillNode = new QQuickPathRenderNode(m_item->window(), m_rootNode);
+        if (m_rootNode->m_strokeNode)
+            m_rootNode->removeChildNode(m_rootNode->m_strokeNode);
+        m_rootNode->appendChildNode(m_rootNode->m_fillNode);
+        if (m_rootNode->m_strokeNode)
+            m_rootNode->appendChildNode(m_rootNode->m_strokeNode);
+        m_renderDirty |= DirtyFillGeom;
+    }
+
+    if (qFuzzyIsNull(m_pen.widthF()) || m_strokeColor.a == 0) {
+        delete m_rootNode->m_strokeNode;
+        m_rootNode->m_strokeNode = nullptr;
+    } else if (!m_rootNode->m_strokeNode) {
+        m_rootNode->m_strokeNode = new QQuickPathRenderNode(m_item->window(), m_rootNode);
+        m_rootNode->appendChildNode(m_rootNode->m_strokeNode);
+        m_renderDirty |= DirtyStrokeGeom;
+    }
+
+    if (m_renderDirty & (DirtyFillGeom | DirtyFillColor))
+        updateFillNode();
+    if (m_renderDirty & (DirtyStrokeGeom | DirtyStrokeColor | DirtyStrokeWidth | DirtyStrokeDash | DirtyStrokeTrim))
+        updateStrokeNode();
+
+    releaseGeometry();
+    m_renderDirty = 0;
+}
+
+static int defaultReleaseThreshold()
+{
+    bool ok = false;
+    const int kb = qEnvironmentVariableIntValue("QT_QUICKPATH_RELEASE_GEOMETRY_SIZE", &ok);
+    return ok ? qBound(0, kb, INT_MAX / 1024) * 1024 : 1024 * 1024;
+}
+
+static QBasicAtomicInt qt_path_release_threshold = Q_BASIC_ATOMIC_INITIALIZER(-1);
+
+int QQuickPathRenderer::releaseThreshold()
+{
+    int bytes = qt_path_release_threshold.load();
+    if (bytes < 0) {
+        bytes = defaultReleaseThreshold();
+        qt_path_release_threshold.testAndSetRelaxed(-1, bytes);
+    }
+    return bytes;
+}
+
+void QQuickPathRenderer::setReleaseThreshold(int bytes)
+{
+    qt_path_release_threshold.store(qMax(0, bytes));
+}
+
+// The bytes dropping v frees. Data that is still referenced elsewhere,
+// usually by the triangulation cache, stays resident and does not count.
+template <typename T>
+static qint64 releasableBytes(const QVector<T> &v)
+{
+    return v.isDetached() ? qint64(v.count()) * qint64(sizeof(T)) : 0;
+}
+
+// QSGGeometry cannot adopt our buffers, it always has a copy of its own.
+// Large geometry that was just uploaded is therefore dropped here, so that
+// it is not resident twice. Color changes are applied to the nodes then,
+// everything else generates the geometry again. Geometry shared with the
+// triangulation cache is kept, dropping it would only lose the cache's
+// benefit without freeing anything.
+void QQuickPathRenderer::releaseGeometry()
+{
+    const int threshold = releaseThreshold();
+    if ((m_renderDirty & DirtyFillGeom) && m_rootNode->m_fillNode) {
+        // the other fill shares m_fill's data when the rule makes no
+        // difference, it is dropped together with it
+        FillGeometry otherFill;
+        qSwap(otherFill, m_otherFill);
+        const qint64 bytes = releasableBytes(m_fill.vertices) + releasableBytes(m_fill.indices)
+                             + releasableBytes(m_fill.curveVertices);
+        if (bytes >= threshold && bytes > 0) {
+            m_fill.vertices = VertexContainer();
+            m_fill.indices = IndexContainer();
+            m_fill.curveVertices = CurveVertexContainer();
+            m_fillPieces.clear();
+            m_otherFillValid = false;
+            m_fillReleased = true;
+        } else {
+            qSwap(otherFill, m_otherFill);
+        }
+    }
+    if ((m_renderDirty & DirtyStrokeGeom) && m_rootNode->m_strokeNode) {
+        const qint64 bytes = releasableBytes(m_strokeVertices) + releasableBytes(m_extrudedStrokeVertices);
+        if (bytes >= threshold && bytes > 0) {
+            m_strokeVertices = VertexContainer();
+            m_extrudedStrokeVertices = ExtrudedVertexContainer();
+            m_strokeReleased = true;
+        }
+    }
+}
+
+// The vertices may carry an outdated color since color changes do not
+// trigger triangulating again, so check when uploading new geometry too.
+// Works for all vertex formats that start like ColoredVertex.
+static void updateVertexColor(QSGGeometry *g, QQuickPathRenderer::Color4ub color, bool force)
+{
+    const int stride = g->sizeOfVertex();
+    char *vdst = static_cast<char *>(g->vertexData());
+    if (!g->vertexCount() || (!force && !memcmp(&reinterpret_cast<ColoredVertex *>(vdst)->color, &color, sizeof(color))))
+        return;
+    for (int i = 0; i < g->vertexCount(); ++i, vdst += stride)
+        reinterpret_cast<ColoredVertex *>(vdst)->color = color;
+}
+
+static void updateFlatColor(QQuickPathRenderNode *n, QQuickPathRenderer::Color4ub color)
+{
+#ifndef QT_NO_OPENGL
+    QSGFlatColorMaterial *m = static_cast<QSGFlatColorMaterial *>(n->material());
+    // the material wants the color unpremultiplied
+    const QColor c = QColor::fromRgba(qUnpremultiply(qRgba(color.r, color.g, color.b, color.a)));
+    if (m && m->color() != c) {
+        m->setColor(c);
+        n->markDirty(QSGNode::DirtyMaterial);
+    }
+#else
+    Q_UNUSED(n);
+    Q_UNUSED(color);
+#endif
+}
+
+// The gradient's direction and the color table are all in the vertices, so
+// that fills with different gradients can be batched. t is calculated from
+// the positions, which are in item coordinates like the gradient.
+static void updateGradientVertices(QSGGeometry *g, const QQuickPathRenderer::GradientDesc &gradient, int row)
+{
+    const QPointF d = gradient.end - gradient.start;
+    const qreal len2 = QPointF::dotProduct(d, d);
+    const float repeat = gradient.spread == QQuickPathGradient::RepeatSpread ? 1 : 0;
+    QQuickPathRenderer::GradientPoint2D *v = static_cast<QQuickPathRenderer::GradientPoint2D *>(g->vertexData());
+    for (int i = 0; i < g->vertexCount(); ++i) {
+        const QPointF p = QPointF(v[i].x, v[i].y) - gradient.start;
+        v[i].t = len2 > 0 ? QPointF::dotProduct(p, d) / len2 : 0;
+        v[i].row = row;
+        v[i].repeat = repeat;
+    }
+}
+
+void QQuickPathRenderer::updateFillNode()
+{
+    if (!m_rootNode->m_fillNode)
+        return;
+
+    // there is no antialiasing for gradients
+    updateFringeNode(m_rootNode->m_fillNode, m_fillGradientActive ? FringeContainer() : m_fill.fringe,
+                     m_fillColor, m_renderDirty & DirtyFillGeom);
+
+    // one node per range, the first one being m_fillNode
+    const int nodeCount = qMax(1, m_fill.ranges.count());
+    QVector<QQuickPathRenderNode *> &extraNodes(m_rootNode->m_extraFillNodes);
+    while (extraNodes.count() > nodeCount - 1)
+        delete extraNodes.takeLast();
+    while (extraNodes.count() < nodeCount - 1) {
+        QQuickPathRenderNode *n = new QQuickPathRenderNode(m_item->window(), m_rootNode);
+        if (m_rootNode->m_strokeNode)
+            m_rootNode->insertChildNodeBefore(n, m_rootNode->m_strokeNode);
+        else
+            m_rootNode->appendChildNode(n);
+        extraNodes.append(n);
+    }
+
+    if (m_fill.ranges.isEmpty()) {
+        const int vertexCount = m_fill.curveVertices.isEmpty() ? m_fill.vertices.count() : m_fill.curveVertices.count();
+        const FillRange all = { 0, vertexCount, 0, m_fill.indices.count() };
+        updateFillNode(m_rootNode->m_fillNode, all);
+    } else {
+        for (int i = 0; i < m_fill.ranges.count(); ++i)
+            updateFillNode(i == 0 ? m_rootNode->m_fillNode : extraNodes[i - 1], m_fill.ranges[i]);
+    }
+}
+
+void QQuickPathRenderer::updateFillNode(QQuickPathRenderNode *n, const FillRange &range)
+{
+    QSGGeometry *g = n->geometry();
+    const bool onlyColorDirty = !(m_renderDirty & DirtyFillGeom);
+    // released geometry is only in the node, the ranges are still valid
+    const bool released = m_fillReleased && onlyColorDirty;
+    if (!range.vertexCount && !released) {
+        if (g->vertexCount()) {
+            g->allocate(0, 0);
+            n->markDirty(QSGNode::DirtyGeometry);
+        }
+        return;
+    }
+
+    const bool curves = released ? g->attributes() == curveColoredAttributes().attributes
+                                 : !m_fill.curveVertices.isEmpty();
+    const bool uniform = m_uniformColor && !m_fillGradientActive && !curves;
+    if (!m_fillGradientActive) {
+        n->activateMaterial(curves ? QQuickPathRenderNode::MatCurve
+                                   : uniform ? QQuickPathRenderNode::MatFlatColor
+                                             : QQuickPathRenderNode::MatSolidColor);
+        n->releaseGradientRow();
+        if (uniform)
+            updateFlatColor(n, m_fillColor);
+        if (onlyColorDirty) {
+            const bool converted = !curves && n->convertVertexFormat(uniform ? QSGGeometry::defaultAttributes_Point2D()
+                                                                             : QSGGeometry::defaultAttributes_ColoredPoint2D());
+            if (!uniform)
+                updateVertexColor(n->geometry(), m_fillColor, true);
+            if (!uniform || converted)
+                n->markDirty(QSGNode::DirtyGeometry);
+            return;
+        }
+    } else {
+        n->activateMaterial(QQuickPathRenderNode::MatLinearGradient);
+        if (onlyColorDirty) {
+            // the positions are all that is needed from the current vertices
+            n->convertVertexFormat(gradientAttributes());
+            updateGradientVertices(n->geometry(), m_fillGradient, n->updateGradientRow(m_fillGradientTable));
+            n->markDirty(QSGNode::DirtyGeometry);
+            return;
+        }
+    }
+
+    if (curves) {
+        g = n->ensureGeometry(curveColoredAttributes(), m_fill.indexType);
+        g->allocate(range.vertexCount, range.indexCount);
+        memcpy(g->vertexData(), m_fill.curveVertices.constData() + range.vertexStart, g->vertexCount() * g->sizeOfVertex());
+    } else if (uniform || m_fillGradientActive) {
+        g = n->ensureGeometry(uniform ? QSGGeometry::defaultAttributes_Point2D() : gradientAttributes(),
+                              m_fill.indexType);
+        g->allocate(range.vertexCount, range.indexCount);
+        copyPositions(g, m_fill.vertices.constData() + range.vertexStart, sizeof(QSGGeometry::ColoredPoint2D));
+        if (m_fillGradientActive)
+            updateGradientVertices(g, m_fillGradient, n->updateGradientRow(m_fillGradientTable));
+    } else {
+        g = n->ensureGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), m_fill.indexType);
+        g->allocate(range.vertexCount, range.indexCount);
+        memcpy(g->vertexData(), m_fill.vertices.constData() + range.vertexStart, g->vertexCount() * g->sizeOfVertex());
+    }
+    g->setDrawingMode(QSGGeometry::DrawTriangles);
+    const quint32 *isrc = m_fill.indices.constData() + range.indexStart;
+    if (m_fill.indexType == QSGGeometry::UnsignedIntType) {
+        memcpy(g->indexData(), isrc, g->indexCount() * g->sizeOfIndex());
+    } else {
+        quint16 *idst = g->indexDataAsUShort();
+        for (int i = 0; i < range.indexCount; ++i)
+            idst[i] = isrc[i];
+    }
+    if (!m_fillGradientActive && !uniform)
+        updateVertexColor(g, m_fillColor, false);
+    n->markDirty(QSGNode::DirtyGeometry);
+}
+
+void QQuickPathRenderer::updateStrokeNode()
+{
+    if (!m_rootNode->m_strokeNode)
+        return;
+
+    QQuickPathRenderNode *n = m_rootNode->m_strokeNode;
+    updateFringeNode(n, m_strokeFringe, m_strokeColor, m_renderDirty & DirtyStrokeGeom);
+
+    QSGGeometry *g = n->geometry();
+    // released geometry is only in the node, only its color can change
+    const bool released = m_strokeReleased && !(m_renderDirty & DirtyStrokeGeom);
+    const bool extruded = released ? g->attributes() == extrudedColoredAttributes().attributes
+                                   : !m_extrudedStrokeVertices.isEmpty();
+    const bool uniform = m_uniformColor && !extruded;
+    if (m_strokeVertices.isEmpty() && !extruded && !released) {
+        if (g->vertexCount()) {
+            g->allocate(0, 0);
+            n->markDirty(QSGNode::DirtyGeometry);
+        }
+        return;
+    }
+
+    if (extruded) {
+        n->activateMaterial(QQuickPathRenderNode::MatExtrudedStroke);
+#ifndef QT_NO_OPENGL
+        QQuickPathExtrudedStrokeMaterial *m = static_cast<QQuickPathExtrudedStrokeMaterial *>(n->material());
+        if (m && m->setPen(m_pen, m_trimStart, m_trimEnd, m_flags.testFlag(RenderAntialiased)))
+            n->markDirty(QSGNode::DirtyMaterial);
+#endif
+    } else if (uniform) {
+        n->activateMaterial(QQuickPathRenderNode::MatFlatColor);
+        updateFlatColor(n, m_strokeColor);
+    } else {
+        n->activateMaterial(QQuickPathRenderNode::MatSolidColor);
+    }
+
+    if (!(m_renderDirty & (DirtyStrokeGeom | DirtyStrokeColor)))
+        return;
+
+    if (!(m_renderDirty & DirtyStrokeGeom)) {
+        const bool converted = !extruded && n->convertVertexFormat(uniform ? QSGGeometry::defaultAttributes_Point2D()
+                                                                           : QSGGeometry::defaultAttributes_ColoredPoint2D());
+        if (!uniform)
+            updateVertexColor(n->geometry(), m_strokeColor, true);
+        if (!uniform || converted)
+            n->markDirty(QSGNode::DirtyGeometry);
+        return;
+    }
+
+    n->markDirty(QSGNode::DirtyGeometry);
+
+    if (extruded) {
+        g = n->ensureGeometry(extrudedColoredAttributes(), QSGGeometry::UnsignedShortType);
+        g->allocate(m_extrudedStrokeVertices.count(), 0);
+        memcpy(g->vertexData(), m_extrudedStrokeVertices.constData(), g->vertexCount() * g->sizeOfVertex());
+    } else if (uniform) {
+        g = n->ensureGeometry(QSGGeometry::defaultAttributes_Point2D(), QSGGeometry::UnsignedShortType);
+        g->allocate(m_strokeVertices.count(), 0);
+        copyPositions(g, m_strokeVertices.constData(), sizeof(QSGGeometry::ColoredPoint2D));
+    } else {
+        g = n->ensureGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), QSGGeometry::UnsignedShortType);
+        g->allocate(m_strokeVertices.count(), 0);
+        memcpy(g->vertexData(), m_strokeVertices.constData(), g->vertexCount() * g->sizeOfVertex());
+    }
     g->setDrawingMode(QSGGeometry::DrawTriangleStrip);
-    memcpy(g->vertexData(), m_strokeVertices.constData(), g->vertexCount() * g->sizeOfVertex());
+    if (!uniform)
+        updateVertexColor(g, m_strokeColor, false);
+}
+
+// Like updateVertexColor() but leaves the outer, transparent vertices alone.
+static void updateFringeColor(QSGGeometry *g, QQuickPathRenderer::Color4ub color, bool force)
+{
+    QQuickPathRenderer::SmoothColoredPoint2D *v = static_cast<QQuickPathRenderer::SmoothColoredPoint2D *>(g->vertexData());
+    if (!g->vertexCount() || (!force && v[0].r == color.r && v[0].g == color.g && v[0].b == color.b && v[0].a == color.a))
+        return;
+    for (int i = 0; i < g->vertexCount(); ++i) {
+        if (v[i].dx == 0 && v[i].dy == 0) {
+            v[i].r = color.r;
+            v[i].g = color.g;
+            v[i].b = color.b;
+            v[i].a = color.a;
+        }
+    }
+}
+
+void QQuickPathRenderer::updateFringeNode(QQuickPathRenderNode *n, const FringeContainer &fringe,
+                                          const Color4ub &color, bool geomDirty)
+{
+    if (fringe.isEmpty()) {
+        delete n->m_fringeNode;
+        n->m_fringeNode = nullptr;
+        return;
+    }
+
+    if (!n->m_fringeNode) {
+        n->m_fringeNode = new QQuickPathFringeNode(m_item->window());
+        n->appendChildNode(n->m_fringeNode);
+        geomDirty = true;
+    }
+
+    QSGGeometry *g = n->m_fringeNode->geometry();
+    if (geomDirty) {
+        g->allocate(fringe.count());
+        memcpy(g->vertexData(), fringe.constData(), g->vertexCount() * g->sizeOfVertex());
+    }
+    updateFringeColor(g, color, !geomDirty);
+    n->m_fringeNode->markDirty(QSGNode::DirtyGeometry);
 }
 
 QT_END_NAMESPACE
@@ -51,31 +51,71 @@
 #include "qquickabstractpathrenderer_p.h"
 #include <qsgnode.h>
 #include <qsggeometry.h>
+#include <QRunnable>
 #include <QtGui/private/qtriangulatingstroker_p.h>
 
 QT_BEGIN_NAMESPACE
 
 class QQuickPathItem;
 class QQuickPathRootRenderNode;
+class QQuickPathRenderNode;
+class QQuickPathFillRunnable;
+class QQuickPathStrokeRunnable;
 
-class QQuickPathRenderer : public QQuickAbstractPathRenderer
+class QQUICKPATH_EXPORT QQuickPathRenderer : public QQuickAbstractPathRenderer
 {
 public:
     enum Dirty {
-        DirtyGeom = 0x01,
-        DirtyColor = 0x02
+        DirtyFillGeom = 0x01,
+        DirtyStrokeGeom = 0x02,
+        DirtyFillColor = 0x04,
+        DirtyStrokeColor = 0x08,
+        DirtyStrokeWidth = 0x10,
+        DirtyStrokeDash = 0x20,
+        DirtyStrokeTrim = 0x40,
+        // m_fill and m_otherFill got swapped
+        DirtyFillRule = 0x80,
+        // gui thread only, see updateColorMode()
+        DirtyColorMode = 0x100
     };
 
     QQuickPathRenderer(QQuickItem *item)
         : m_item(item),
           m_rootNode(nullptr),
-          m_renderDirty(0)
+          m_piecesChangeFirst(-1),
+          m_piecesChangeLast(-1),
+          m_renderDirty(0),
+          m_scale(1),
+          m_otherFillValid(false),
+          m_fillRuleToggled(false),
+          m_strokeExtruded(false),
+          m_fillReleased(false),
+          m_strokeReleased(false),
+          m_colorMode(QQuickPathItem::AutomaticColor),
+          m_colorOnlySyncs(0),
+          m_idleFrames(0),
+          m_uniformColor(false),
+          m_trimStart(0),
+          m_trimEnd(1),
+          m_asyncCallback(nullptr),
+          m_asyncCallbackData(nullptr),
+          m_pendingFill(nullptr),
+          m_pendingStroke(nullptr)
           { }
+    ~QQuickPathRenderer();
 
     void setRootNode(QQuickPathRootRenderNode *rn);
 
+    Capabilities capabilities() const override { return SupportsAsync | ScaleDependent; }
+
     void beginSync() override;
     void setPath(const QPainterPath &path) override;
+    void updatePath(const QPainterPath &path, int firstElement, int lastElement) override;
+    void setFillRule(Qt::FillRule fillRule) override;
+    void setPrimitives(const QVector<QQuickPathPrimitive> &primitives) override;
+    void setScale(qreal scale) override;
+    void setStrokeTrim(qreal start, qreal end) override;
+    void setColorMode(QQuickPathItem::ColorMode mode) override;
     void setFillColor(const QColor &color, QQuickPathGradient *gradient) override;
     void setStrokeColor(const QColor &color) override;
     void setStrokeWidth(qreal w) override;
@@ -85,11 +125,187 @@ public:
     void setStrokeStyle(QQuickPathItem::StrokeStyle strokeStyle,
                         qreal dashOffset, const QVector<qreal> &dashPattern,
                         bool cosmeticStroke) override;
-    void endSync() override;
+    void endSync(bool async) override;
+    void setAsyncCallback(void (*)(void *), void *) override;
+    bool advanceFrame() override;
     void updatePathRenderNode() override;
 
     struct Color4ub { unsigned char r, g, b, a; };
 
+    typedef QVector<QSGGeometry::ColoredPoint2D> VertexContainer;
+    typedef QVector<quint32> IndexContainer;
+
+    // Antialiasing fringe vertex. The offset is the direction in which the
+    // vertex gets pushed outwards in the vertex shader, its length is the
+    // distance in device pixels. Drawn as a single triangle strip.
+    struct SmoothColoredPoint2D {
+        float x, y;
+        unsigned char r, g, b, a;
+        float dx, dy;
+    };
+    typedef QVector<SmoothColoredPoint2D> FringeContainer;
+    static const QSGGeometry::AttributeSet &smoothColoredAttributes();
+
+    // Vertex for fills with curves evaluated in the fragment shader. (u, v)
+    // are the canonical quadratic coordinates, s is the side of the curve
+    // that is filled (-1 or 1), or 0 for plain interior triangles.
+    struct CurveColoredPoint2D {
+        float x, y;
+        unsigned char r, g, b, a;
+        float u, v, s;
+    };
+    typedef QVector<CurveColoredPoint2D> CurveVertexContainer;
+    static const QSGGeometry::AttributeSet &curveColoredAttributes();
+
+    // Stroke vertex that does not depend on the stroke width. The vertex
+    // shader moves the centerline point by the offset times half the width.
+    // side is -1 or 1 on the edges of the stroke and 0 on the centerline,
+    // used for antialiasing. length is the distance along the subpath, the
+    // fragment shader applies the dash pattern based on it. position is the
+    // distance along the whole path as a fraction of its length, for trimming.
+    struct ExtrudedColoredPoint2D {
+        float x, y;
+        unsigned char r, g, b, a;
+        float dx, dy, side;
+        float length, position;
+    };
+    typedef QVector<ExtrudedColoredPoint2D> ExtrudedVertexContainer;
+    static const QSGGeometry::AttributeSet &extrudedColoredAttributes();
+
+    // Vertex for gradient fills, only ever created from the positions of
+    // other vertices when uploading. t is the position along the gradient
+    // as a fraction of its length, row is the row of the color table in the
+    // gradient cache's texture, repeat is 1 for RepeatSpread, 0 otherwise.
+    struct GradientPoint2D {
+        float x, y;
+        float t, row, repeat;
+    };
+    static const QSGGeometry::AttributeSet &gradientAttributes();
+
+    struct FillRange {
+        int vertexStart;
+        int vertexCount;
+        int indexStart;
+        int indexCount;
+    };
+
+    struct FillGeometry {
+        FillGeometry() : indexType(QSGGeometry::UnsignedShortType) { }
+        VertexContainer vertices;
+        IndexContainer indices;
+        QSGGeometry::Type indexType;
+        // Non-empty only when the mesh had to be split up due to not having
+        // 32-bit index support. Each range is rendered by a separate node then
+        // and its indices are relative to the range's first vertex.
+        QVector<FillRange> ranges;
+        // empty unless antialiasing was requested
+        FringeContainer fringe;
+        // used instead of vertices when the fill has curve triangles
+        CurveVertexContainer curveVertices;
+    };
+
+    // A group of subpaths whose bounds do not overlap the rest of the path.
+    // The fill of such a group does not depend on the other subpaths, with
+    // either fill rule, so it is triangulated on its own and kept around for
+    // the next time the path changes.
+    struct FillPiece {
+        QPainterPath path;
+        // the first element of each subpath in the path the piece is part of
+        QVector<int> subpaths;
+        FillGeometry fill;
+        FillGeometry otherFill;
+    };
+    typedef QVector<FillPiece> FillPieceContainer;
+
+    // These are safe to call from any thread, they only operate on their
+    // arguments. scale is the scale from item coordinates to device pixels,
+    // curves are flattened based on it.
+    static void triangulateFill(const QVectorPath &vp,
+                                const Color4ub &fillColor,
+                                FillGeometry *fill,
+                                bool supportsElementIndexUint,
+                                bool antialiasing = false,
+                                qreal scale = 1);
+    // Like triangulateFill() but the curves are not flattened: the interior
+    // is triangulated on the control polygon and each quadratic segment adds
+    // one triangle that gets clipped to the curve in the fragment shader.
+    // Cubics are approximated by quadratics. Returns false when the result
+    // would have to be split up, the caller should fall back then.
+    static bool triangulateCurveFill(const QVectorPath &vp,
+                                     const Color4ub &fillColor,
+                                     FillGeometry *fill,
+                                     bool supportsElementIndexUint,
+                                     qreal scale = 1);
+    // True when the fill looks the same with both fill rules, i.e. the path
+    // is a single contour that does not intersect itself. Conservative, large
+    // concave contours are not checked.
+    static bool isFillRuleIndependent(const QVectorPath &vp, qreal scale = 1);
+    // Triangulates the path with its own fill rule into fill and, unless it
+    // is null, with the other one into otherFill, piece by piece. Pieces that have the same
+    // subpaths as one in previous are taken from there instead of being
+    // triangulated again. previous must have been generated with the same
+    // arguments apart from the path and the color, including whether
+    // otherFill is null. Returns false, leaving
+    // pieces empty, when the path does not split up into multiple pieces.
+    // A non-negative changedFirst means that path has the same elements as
+    // the one previous was made from, except for the positions of the ones
+    // in [changedFirst, changedLast]. Pieces outside of that range are then
+    // matched without comparing their elements.
+    static bool triangulateFillPieces(const QPainterPath &path,
+                                      const Color4ub &fillColor,
+                                      const FillPieceContainer &previous,
+                                      FillPieceContainer *pieces,
+                                      FillGeometry *fill,
+                                      FillGeometry *otherFill,
+                                      bool supportsElementIndexUint,
+                                      bool antialiasing = false,
+                                      qreal scale = 1,
+                                      int changedFirst = -1,
+                                      int changedLast = -1);
+    static void triangulateStroke(const QVectorPath &vp,
+                                  const QPen &pen,
+                                  const Color4ub &strokeColor,
+                                  VertexContainer *strokeVertices,
+                                  const QSizeF &clipSize,
+                                  FringeContainer *strokeFringe = nullptr,
+                                  qreal scale = 1);
+
+    // Strokes as a triangle strip of ExtrudedColoredPoint2D so that the width
+    // and the dash pattern can change without generating the geometry again.
+    // The pen's width is only used to pick the number of segments in round
+    // joins and caps. Other strokes go through QTriangulatingStroker, and so
+    // does everything when the shaders cannot be antialiased. Must be called
+    // on the gui thread.
+    enum { MaxExtrudedDashPattern = 8 };
+    static bool isExtrudable(const QPen &pen)
+    {
+        return !pen.isCosmetic() && pen.dashPattern().count() <= MaxExtrudedDashPattern
+                && supportsStandardDerivatives();
+    }
+    static void extrudeStroke(const QVectorPath &vp,
+                              const QPen &pen,
+                              const Color4ub &strokeColor,
+                              ExtrudedVertexContainer *strokeVertices,
+                              qreal scale = 1);
+
+    // The part of the path between start and end, as a fraction of its length.
+    static QPainterPath trimPath(const QPainterPath &path, qreal start, qreal end);
+
+    // Geometry for paths consisting of rectangles and ellipses only, without
+    // going through the triangulator or the stroker. Return false when the
+    // shapes are not handled, e.g. because they overlap.
+    static bool generatePrimitiveFill(const QVector<QQuickPathPrimitive> &primitives,
+                                      const Color4ub &fillColor,
+                                      qreal scale,
+                                      FillGeometry *fill,
+                                      bool antialiasing = false);
+    static bool generatePrimitiveStroke(const QVector<QQuickPathPrimitive> &primitives,
+                                        const QPen &pen,
+                                        const Color4ub &strokeColor,
+                                        qreal scale,
+                                        VertexContainer *strokeVertices,
+                                        FringeContainer *strokeFringe = nullptr);
+
     struct GradientDesc {
         QGradientStops stops;
         QPointF start;
@@ -102,45 +318,180 @@ public:
         }
     };
 
+    // a 64-bit hash over all stops, with the positions and the colors at
+    // full precision
+    static quint64 gradientStopsHash(const QGradientStops &stops);
+
+    enum { GradientTableWidth = 1024 };
+
+    // A gradient's color table, premultiplied RGBA, as it goes into the
+    // gradient cache. It is generated on the gui thread so that the render
+    // thread only uploads it, always GradientTableWidth texels.
+    struct GradientTable {
+        GradientTable() : hash(0) { }
+        QGradientStops stops;
+        quint64 hash;
+        QVector<uint> texels;
+    };
+
+    // Regenerates table unless it already has the stops.
+    static void updateGradientTable(GradientTable *table, const QGradientStops &stops);
+    static void generateGradientColorTable(const QGradientStops &stops,
+                                           uint *colorTable, int size, float opacity);
+
     bool isFillGradientActive() const { return m_fillGradientActive; }
     const GradientDesc *fillGradient() const { return &m_fillGradient; }
+    const GradientTable *fillGradientTable() const { return &m_fillGradientTable; }
+
+    // Fill and stroke geometry of at least this many bytes is not kept once
+    // it is uploaded to the nodes. Defaults to QT_QUICKPATH_RELEASE_GEOMETRY_SIZE
+    // (in kilobytes) or 1 MB.
+    static int releaseThreshold();
+    static void setReleaseThreshold(int bytes);
+    // true when new nodes need the geometry generated again
+    bool hasReleasedGeometry() const { return m_fillReleased || m_strokeReleased; }
 
 private:
-    void triangulateFill();
-    void triangulateStroke();
+    static bool supportsElementIndexUint();
+    static bool supportsStandardDerivatives();
+    void maybeUpdateAsyncItem();
+    void updateColorMode();
     void updateFillNode();
+    void updateFillNode(QQuickPathRenderNode *n, const FillRange &range);
     void updateStrokeNode();
+    void updateFringeNode(QQuickPathRenderNode *n, const FringeContainer &fringe,
+                          const Color4ub &color, bool geomDirty);
+    void releaseGeometry();
 
     QQuickItem *m_item;
     QQuickPathRootRenderNode *m_rootNode;
-    QTriangulatingStroker m_stroker;
-    QDashedStrokeProcessor m_dashStroker;
 
     RenderFlags m_flags;
     QPen m_pen;
     Color4ub m_fillColor;
     Color4ub m_strokeColor;
     QPainterPath m_path;
+    QVector<QQuickPathPrimitive> m_primitives;
 
-    QVector<QSGGeometry::ColoredPoint2D> m_fillVertices;
-    QVector<quint16> m_fillIndices;
-    QVector<QSGGeometry::ColoredPoint2D> m_strokeVertices;
+    FillGeometry m_fill;
+    // the fill with the other fill rule, generated together with m_fill once
+    // the rule was changed so that changing it again only needs swapping the
+    // two
+    FillGeometry m_otherFill;
+    // what m_fill was assembled from, empty when it was not split up
+    FillPieceContainer m_fillPieces;
+    // The elements whose positions differ between m_path and the path
+    // m_fillPieces was made from. m_piecesChangeFirst is -1 when the two
+    // may differ in other ways too.
+    int m_piecesChangeFirst;
+    int m_piecesChangeLast;
+    VertexContainer m_strokeVertices;
+    FringeContainer m_strokeFringe;
+    // used instead of m_strokeVertices when non-empty
+    ExtrudedVertexContainer m_extrudedStrokeVertices;
 
     int m_guiDirty;
     int m_renderDirty;
+    qreal m_scale;
+    bool m_otherFillValid;
+    // setFillRule() changed the rule at least once, m_otherFill is generated
+    // from then on
+    bool m_fillRuleToggled;
+    // the stroke geometry (being) generated does not depend on the width
+    bool m_strokeExtruded;
+    // The vertices and indices were dropped after uploading, only the nodes
+    // have them. The fringes and the fill's ranges are kept.
+    bool m_fillReleased;
+    bool m_strokeReleased;
+    QQuickPathItem::ColorMode m_colorMode;
+    // consecutive syncs that changed nothing but colors
+    int m_colorOnlySyncs;
+    // frames since the last sync
+    int m_idleFrames;
+    // solid fills and plain strokes are uploaded without per-vertex colors
+    bool m_uniformColor;
+    qreal m_trimStart;
+    qreal m_trimEnd;
+
+    void (*m_asyncCallback)(void *);
+    void *m_asyncCallbackData;
+    QQuickPathFillRunnable *m_pendingFill;
+    QQuickPathStrokeRunnable *m_pendingStroke;
 
     bool m_fillGradientActive;
     GradientDesc m_fillGradient;
+    GradientTable m_fillGradientTable;
 };
 
-inline uint qHash(const QQuickPathRenderer::GradientDesc &v, uint seed = 0)
+class QQuickPathFillRunnable : public QObject, public QRunnable
 {
-    uint h = seed;
-    h += v.start.x() + v.end.y() + v.spread;
-    for (int i = 0; i < 3 && i < v.stops.count(); ++i)
-        h += v.stops[i].second.rgba();
-    return h;
-}
+    Q_OBJECT
+
+public:
+    void run() override;
+
+    // set on the gui thread when the results are no longer wanted
+    QAtomicInt orphaned;
+
+    // input
+    QPainterPath path;
+    QQuickPathRenderer::Color4ub fillColor;
+    bool supportsElementIndexUint;
+    bool antialiasing;
+    bool curves;
+    // triangulate with the other fill rule too, into otherFill
+    bool bothRules;
+    qreal scale;
+    QQuickPathRenderer::FillPieceContainer previousPieces;
+    int changedFirst;
+    int changedLast;
+
+    // output, for the path's fill rule and the other one when bothRules is set
+    QQuickPathRenderer::FillGeometry fill;
+    QQuickPathRenderer::FillGeometry otherFill;
+    QQuickPathRenderer::FillPieceContainer pieces;
+
+signals:
+    void done(QQuickPathFillRunnable *self);
+};
+
+class QQuickPathStrokeRunnable : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    void run() override;
+
+    // set on the gui thread when the results are no longer wanted
+    QAtomicInt orphaned;
+
+    // input
+    QPainterPath path;
+    QPen pen;
+    bool extruded;
+    QQuickPathRenderer::Color4ub strokeColor;
+    QSizeF clipSize;
+    bool antialiasing;
+    qreal scale;
+
+    // output
+    QQuickPathRenderer::VertexContainer strokeVertices;
+    QQuickPathRenderer::FringeContainer strokeFringe;
+    QQuickPathRenderer::ExtrudedVertexContainer extrudedStrokeVertices;
+
+signals:
+    void done(QQuickPathStrokeRunnable *self);
+};
+
+// Child of a fill or stroke node, rendered after its parent.
+class QQuickPathFringeNode : public QSGGeometryNode
+{
+public:
+    QQuickPathFringeNode(QQuickWindow *window);
+
+private:
+    QScopedPointer<QSGMaterial> m_material;
+};
 
 class QQuickPathRenderNode : public QSGGeometryNode
 {
@@ -150,24 +501,41 @@ public:
 
     enum Material {
         MatSolidColor,
-        MatLinearGradient
+        MatLinearGradient,
+        MatCurve,
+        MatExtrudedStroke,
+        MatFlatColor
     };
 
     void activateMaterial(Material m);
+    // Replaces the geometry when the vertex format or the index type changes.
+    QSGGeometry *ensureGeometry(const QSGGeometry::AttributeSet &attrs, QSGGeometry::Type indexType);
+    // Switches between the Point2D, ColoredPoint2D and GradientPoint2D
+    // formats, keeping the positions and the indices. The rest of the vertex
+    // data is zeroed. Returns false when the format was already attrs.
+    bool convertVertexFormat(const QSGGeometry::AttributeSet &attrs);
+    // Returns the row of the gradient cache's texture with the color table
+    // and points the gradient material to the texture's page. The node keeps
+    // the row referenced until the table changes or releaseGradientRow() is
+    // called.
+    int updateGradientRow(const QQuickPathRenderer::GradientTable &table);
+    void releaseGradientRow();
 
     QQuickWindow *window() const { return m_window; }
     QQuickPathRootRenderNode *rootNode() const { return m_rootNode; }
-    int dirty() const { return m_dirty; }
-    void resetDirty() { m_dirty = 0; }
 
 private:
-    QSGGeometry m_geometry;
+    QSGGeometry *m_geometry;
     QQuickWindow *m_window;
     QQuickPathRootRenderNode *m_rootNode;
-    int m_dirty;
+    int m_gradientRow;
     QSGMaterial *m_material;
     QScopedPointer<QSGMaterial> m_solidColorMaterial;
     QScopedPointer<QSGMaterial> m_linearGradientMaterial;
+    QScopedPointer<QSGMaterial> m_curveMaterial;
+    QScopedPointer<QSGMaterial> m_extrudedStrokeMaterial;
+    QScopedPointer<QSGMaterial> m_flatColorMaterial;
+    QQuickPathFringeNode *m_fringeNode;
 
     friend class QQuickPathRenderer;
 };
@@ -182,6 +550,8 @@ public:
 
 private:
     QQuickPathRenderNode *m_fillNode;
+    // additional nodes for the parts of a split up fill, come after m_fillNode
+    QVector<QQuickPathRenderNode *> m_extraFillNodes;
     QQuickPathRenderNode *m_strokeNode;
     QQuickPathRenderer *m_renderer;
 
@@ -0,0 +1,106 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtQuickPath module
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QQUICKPATHSMOOTHCOLORMATERIAL_P_H
+#define QQUICKPATHSMOOTHCOLORMATERIAL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of a number of Qt sources files.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuickPath/qtquickpathglobal.h>
+#include <qsgmaterial.h>
+
+QT_BEGIN_NAMESPACE
+
+#ifndef QT_NO_OPENGL
+
+class QQuickPathSmoothColorShader : public QSGMaterialShader
+{
+public:
+    QQuickPathSmoothColorShader();
+
+    void initialize() override;
+    void updateState(const RenderState &state, QSGMaterial *newEffect, QSGMaterial *oldEffect) override;
+    char const *const *attributeNames() const override;
+
+    static QSGMaterialType type;
+
+private:
+    int m_opacityLoc;
+    int m_matrixLoc;
+    int m_pixelSizeLoc;
+};
+
+// Per-vertex color with vertices pushed outwards by a distance given in
+// device pixels. There is no per-item state so all instances batch together.
+class QQuickPathSmoothColorMaterial : public QSGMaterial
+{
+public:
+    QQuickPathSmoothColorMaterial()
+    {
+        // merging must not apply more than a translation, the offsets are not transformed
+        setFlag(Blending | RequiresFullMatrixExceptTranslate);
+    }
+
+    QSGMaterialType *type() const override
+    {
+        return &QQuickPathSmoothColorShader::type;
+    }
+
+    int compare(const QSGMaterial *) const override
+    {
+        return 0;
+    }
+
+    QSGMaterialShader *createShader() const override
+    {
+        return new QQuickPathSmoothColorShader;
+    }
+};
+
+#endif // QT_NO_OPENGL
+
+QT_END_NAMESPACE
+
+#endif
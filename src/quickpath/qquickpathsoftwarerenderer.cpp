@@ -0,0 +1,271 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtQuickPath module
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qquickpathsoftwarerenderer_p.h"
+#include "qquickpathrendernode_p.h"
+#include <QQuickWindow>
+#include <QSGRendererInterface>
+#include <QPainter>
+#include <qmath.h>
+
+QT_BEGIN_NAMESPACE
+
+QQuickPathSoftwareRenderer::~QQuickPathSoftwareRenderer()
+{
+    if (m_node)
+        m_node->m_renderer = nullptr;
+}
+
+void QQuickPathSoftwareRenderer::setNode(QQuickPathSoftwareRenderNode *node)
+{
+    if (m_node != node) {
+        if (m_node)
+            m_node->m_renderer = nullptr;
+        m_node = node;
+        if (m_node)
+            m_node->m_renderer = this;
+        // a new node needs everything
+        m_renderDirty = DirtyPath | DirtyPen | DirtyBrush | DirtyFlags | DirtyTrim;
+    }
+}
+
+void QQuickPathSoftwareRenderer::beginSync()
+{
+    m_guiDirty = 0;
+}
+
+void QQuickPathSoftwareRenderer::setPath(const QPainterPath &path)
+{
+    m_path = path;
+    m_guiDirty |= DirtyPath;
+}
+
+void QQuickPathSoftwareRenderer::setFillRule(Qt::FillRule fillRule)
+{
+    m_path.setFillRule(fillRule);
+    m_guiDirty |= DirtyPath;
+}
+
+void QQuickPathSoftwareRenderer::setFillColor(const QColor &color, QQuickPathGradient *gradient)
+{
+    if (gradient) {
+        QLinearGradient g(gradient->x1(), gradient->y1(), gradient->x2(), gradient->y2());
+        g.setStops(gradient->sortedGradientStops());
+        g.setSpread(gradient->spread() == QQuickPathGradient::RepeatSpread ? QGradient::RepeatSpread
+                                                                           : QGradient::PadSpread);
+        m_brush = QBrush(g);
+    } else {
+        m_brush = color.alpha() ? QBrush(color) : QBrush(Qt::NoBrush);
+    }
+    m_guiDirty |= DirtyBrush;
+}
+
+void QQuickPathSoftwareRenderer::setStrokeColor(const QColor &color)
+{
+    m_pen.setColor(color);
+    m_guiDirty |= DirtyPen;
+}
+
+void QQuickPathSoftwareRenderer::setStrokeWidth(qreal w)
+{
+    m_pen.setWidthF(w);
+    m_guiDirty |= DirtyPen;
+}
+
+void QQuickPathSoftwareRenderer::setFlags(RenderFlags flags)
+{
+    m_flags = flags;
+    m_guiDirty |= DirtyFlags;
+}
+
+void QQuickPathSoftwareRenderer::setStrokeTrim(qreal start, qreal end)
+{
+    if (m_trimStart == start && m_trimEnd == end)
+        return;
+    m_trimStart = start;
+    m_trimEnd = end;
+    m_guiDirty |= DirtyTrim;
+}
+
+void QQuickPathSoftwareRenderer::setJoinStyle(QQuickPathItem::JoinStyle joinStyle, int miterLimit)
+{
+    m_pen.setJoinStyle(Qt::PenJoinStyle(joinStyle));
+    m_pen.setMiterLimit(miterLimit);
+    m_guiDirty |= DirtyPen;
+}
+
+void QQuickPathSoftwareRenderer::setCapStyle(QQuickPathItem::CapStyle capStyle)
+{
+    m_pen.setCapStyle(Qt::PenCapStyle(capStyle));
+    m_guiDirty |= DirtyPen;
+}
+
+void QQuickPathSoftwareRenderer::setStrokeStyle(QQuickPathItem::StrokeStyle strokeStyle,
+                                                qreal dashOffset, const QVector<qreal> &dashPattern,
+                                                bool cosmeticStroke)
+{
+    m_pen.setStyle(Qt::PenStyle(strokeStyle));
+    if (strokeStyle == QQuickPathItem::DashLine) {
+        m_pen.setDashPattern(dashPattern);
+        m_pen.setDashOffset(dashOffset);
+    }
+    m_pen.setCosmetic(cosmeticStroke);
+    m_guiDirty |= DirtyPen;
+}
+
+void QQuickPathSoftwareRenderer::endSync(bool)
+{
+    // nothing to calculate, QPainter takes care of everything while rendering
+    m_renderDirty |= m_guiDirty;
+}
+
+void QQuickPathSoftwareRenderer::updatePathRenderNode()
+{
+    if (!m_renderDirty || !m_node)
+        return;
+
+    if (m_renderDirty & DirtyPath)
+        m_node->m_path = m_path;
+
+    if (m_renderDirty & (DirtyPath | DirtyTrim)) {
+        m_node->m_trimmed = m_trimStart > 0 || m_trimEnd < 1;
+        m_node->m_strokePath = QQuickPathRenderer::trimPath(m_path, m_trimStart, m_trimEnd);
+    }
+
+    if (m_renderDirty & DirtyPen) {
+        // QPainter treats 0 as a 1 pixel wide cosmetic pen, we want no stroke instead
+        if (qFuzzyIsNull(m_pen.widthF()) || !m_pen.color().alpha())
+            m_node->m_pen = QPen(Qt::NoPen);
+        else
+            m_node->m_pen = m_pen;
+    }
+
+    if (m_renderDirty & DirtyBrush)
+        m_node->m_brush = m_brush;
+
+    if (m_renderDirty & DirtyFlags)
+        m_node->m_antialiasing = m_flags.testFlag(RenderAntialiased);
+
+    if (m_renderDirty & (DirtyPath | DirtyPen)) {
+        // Keep the rect as tight as possible since the software renderer
+        // repaints all of it whenever the node changes.
+        QRectF br = m_path.boundingRect();
+        const QPen &pen(m_node->m_pen);
+        if (!m_path.isEmpty() && pen.style() != Qt::NoPen) {
+            qreal factor = 1;
+            if (pen.joinStyle() == Qt::MiterJoin)
+                factor = qMax<qreal>(factor, pen.miterLimit());
+            if (pen.capStyle() == Qt::SquareCap)
+                factor = qMax<qreal>(factor, M_SQRT2);
+            const qreal w = pen.widthF() / 2 * factor;
+            br.adjust(-w, -w, w, w);
+        }
+        // room for antialiasing
+        if (!br.isEmpty())
+            br.adjust(-1, -1, 1, 1);
+        m_node->m_boundingRect = br;
+    }
+
+    m_node->markDirty(QSGNode::DirtyMaterial);
+    m_renderDirty = 0;
+}
+
+QQuickPathSoftwareRenderNode::QQuickPathSoftwareRenderNode(QQuickItem *item)
+    : m_item(item),
+      m_renderer(nullptr),
+      m_trimmed(false),
+      m_antialiasing(false)
+{
+}
+
+QQuickPathSoftwareRenderNode::~QQuickPathSoftwareRenderNode()
+{
+    releaseResources();
+    // the renderer must not touch the node after the scenegraph deleted it
+    if (m_renderer)
+        m_renderer->setNode(nullptr);
+}
+
+void QQuickPathSoftwareRenderNode::releaseResources()
+{
+}
+
+void QQuickPathSoftwareRenderNode::render(const RenderState *state)
+{
+    if (m_path.isEmpty())
+        return;
+
+    QSGRendererInterface *rif = m_item->window()->rendererInterface();
+    QPainter *p = static_cast<QPainter *>(rif->getResource(m_item->window(), QSGRendererInterface::PainterResource));
+    Q_ASSERT(p);
+
+    p->setTransform(matrix()->toTransform());
+    p->setOpacity(inheritedOpacity());
+    const QRegion *clipRegion = state->clipRegion();
+    if (clipRegion && !clipRegion->isEmpty())
+        p->setClipRegion(*clipRegion, Qt::IntersectClip);
+
+    p->setRenderHint(QPainter::Antialiasing, m_antialiasing);
+    if (m_trimmed) {
+        p->setPen(Qt::NoPen);
+        p->setBrush(m_brush);
+        p->drawPath(m_path);
+        p->setPen(m_pen);
+        p->setBrush(Qt::NoBrush);
+        p->drawPath(m_strokePath);
+    } else {
+        p->setPen(m_pen);
+        p->setBrush(m_brush);
+        p->drawPath(m_path);
+    }
+}
+
+QSGRenderNode::StateFlags QQuickPathSoftwareRenderNode::changedStates() const
+{
+    return 0;
+}
+
+QSGRenderNode::RenderingFlags QQuickPathSoftwareRenderNode::flags() const
+{
+    return BoundedRectRendering; // avoid fullscreen updates by saying we won't draw outside rect()
+}
+
+QRectF QQuickPathSoftwareRenderNode::rect() const
+{
+    return m_boundingRect;
+}
+
+QT_END_NAMESPACE
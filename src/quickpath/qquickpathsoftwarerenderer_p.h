@@ -0,0 +1,144 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtQuickPath module
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QQUICKPATHSOFTWARERENDERER_P_H
+#define QQUICKPATHSOFTWARERENDERER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of a number of Qt sources files.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qquickabstractpathrenderer_p.h"
+#include <qsgrendernode.h>
+#include <QPen>
+#include <QBrush>
+
+QT_BEGIN_NAMESPACE
+
+class QQuickPathSoftwareRenderNode;
+
+// For QT_QUICK_BACKEND=software. Paths are drawn with QPainter as-is, there
+// is no triangulation involved.
+class QQuickPathSoftwareRenderer : public QQuickAbstractPathRenderer
+{
+public:
+    enum Dirty {
+        DirtyPath = 0x01,
+        DirtyPen = 0x02,
+        DirtyBrush = 0x04,
+        DirtyFlags = 0x08,
+        DirtyTrim = 0x10
+    };
+
+    QQuickPathSoftwareRenderer()
+        : m_node(nullptr),
+          m_guiDirty(0),
+          m_renderDirty(0),
+          m_trimStart(0),
+          m_trimEnd(1)
+    { }
+    ~QQuickPathSoftwareRenderer();
+
+    // node is null when the scenegraph deleted the node
+    void setNode(QQuickPathSoftwareRenderNode *node);
+
+    void beginSync() override;
+    void setPath(const QPainterPath &path) override;
+    void setFillRule(Qt::FillRule fillRule) override;
+    void setFillColor(const QColor &color, QQuickPathGradient *gradient) override;
+    void setStrokeColor(const QColor &color) override;
+    void setStrokeWidth(qreal w) override;
+    void setFlags(RenderFlags flags) override;
+    void setStrokeTrim(qreal start, qreal end) override;
+    void setJoinStyle(QQuickPathItem::JoinStyle joinStyle, int miterLimit) override;
+    void setCapStyle(QQuickPathItem::CapStyle capStyle) override;
+    void setStrokeStyle(QQuickPathItem::StrokeStyle strokeStyle,
+                        qreal dashOffset, const QVector<qreal> &dashPattern,
+                        bool cosmeticStroke) override;
+    void endSync(bool async) override;
+    void updatePathRenderNode() override;
+
+private:
+    QQuickPathSoftwareRenderNode *m_node;
+    int m_guiDirty;
+    int m_renderDirty;
+    QPainterPath m_path;
+    QPen m_pen;
+    QBrush m_brush;
+    RenderFlags m_flags;
+    qreal m_trimStart;
+    qreal m_trimEnd;
+};
+
+class QQuickPathSoftwareRenderNode : public QSGRenderNode
+{
+public:
+    QQuickPathSoftwareRenderNode(QQuickItem *item);
+    ~QQuickPathSoftwareRenderNode();
+
+    void render(const RenderState *state) override;
+    void releaseResources() override;
+    StateFlags changedStates() const override;
+    RenderingFlags flags() const override;
+    QRectF rect() const override;
+
+private:
+    QQuickItem *m_item;
+    // cleared when either side goes away first
+    QQuickPathSoftwareRenderer *m_renderer;
+
+    QPainterPath m_path;
+    // only differs from m_path when the stroke is trimmed
+    QPainterPath m_strokePath;
+    bool m_trimmed;
+    QPen m_pen;
+    QBrush m_brush;
+    bool m_antialiasing;
+    QRectF m_boundingRect;
+
+    friend class QQuickPathSoftwareRenderer;
+};
+
+QT_END_NAMESPACE
+
+#endif
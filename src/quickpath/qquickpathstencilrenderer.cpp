@@ -0,0 +1,542 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtQuickPath module
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qquickpathstencilrenderer_p.h"
+#include "qquickpathgradientmaterial_p.h"
+#include <QQuickWindow>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#include <QSGTexture>
+#include <QtGui/private/qbezier_p.h>
+#include <QtGui/private/qpainterpath_p.h>
+
+#ifndef QT_NO_OPENGL
+
+QT_BEGIN_NAMESPACE
+
+// Curves are flattened so that they stay within this many device pixels of
+// the real curve.
+static const qreal CURVE_TOLERANCE = 0.25;
+
+// Stencil layout while rendering: the top bit marks the pixels the item may
+// draw to (i.e. inside the scenegraph's stencil clip), the rest holds the
+// winding number modulo 128.
+static const GLuint INSIDE_BIT = 0x80;
+static const GLuint COUNT_BITS = 0x7F;
+
+// the quads at the start of the vertex buffer
+enum {
+    BoundsRect,
+    FillRect,
+    StrokeRect,
+    RectCount
+};
+
+void QQuickPathStencilRenderer::setNode(QQuickPathStencilRenderNode *node)
+{
+    if (m_node != node) {
+        m_node = node;
+        // a new node needs everything
+        m_renderDirty = DirtyFillGeom | DirtyStrokeGeom | DirtyFillColor | DirtyStrokeColor | DirtyFillRule;
+    }
+}
+
+void QQuickPathStencilRenderer::beginSync()
+{
+    m_guiDirty = 0;
+}
+
+void QQuickPathStencilRenderer::setPath(const QPainterPath &path)
+{
+    m_path = path;
+    m_guiDirty |= DirtyFillGeom | DirtyStrokeGeom;
+}
+
+void QQuickPathStencilRenderer::setFillRule(Qt::FillRule fillRule)
+{
+    // the fans are the same for both rules, only the cover pass differs
+    m_path.setFillRule(fillRule);
+    m_guiDirty |= DirtyFillRule;
+}
+
+void QQuickPathStencilRenderer::setScale(qreal scale)
+{
+    if (m_scale == scale)
+        return;
+    m_scale = scale;
+    m_guiDirty |= DirtyFillGeom | DirtyStrokeGeom;
+}
+
+void QQuickPathStencilRenderer::setStrokeTrim(qreal start, qreal end)
+{
+    if (m_trimStart == start && m_trimEnd == end)
+        return;
+    m_trimStart = start;
+    m_trimEnd = end;
+    m_guiDirty |= DirtyStrokeGeom;
+}
+
+void QQuickPathStencilRenderer::setFillColor(const QColor &color, QQuickPathGradient *gradient)
+{
+    m_fillColor = color;
+    m_fillGradientActive = gradient != nullptr;
+    if (gradient) {
+        m_fillGradient.stops = gradient->sortedGradientStops();
+        m_fillGradient.start = QPointF(gradient->x1(), gradient->y1());
+        m_fillGradient.end = QPointF(gradient->x2(), gradient->y2());
+        m_fillGradient.spread = gradient->spread();
+        QQuickPathRenderer::updateGradientTable(&m_fillGradientTable, m_fillGradient.stops);
+    }
+    m_guiDirty |= DirtyFillColor;
+}
+
+void QQuickPathStencilRenderer::setStrokeColor(const QColor &color)
+{
+    // a transparent stroke has no geometry
+    if ((m_strokeColor.alpha() == 0) != (color.alpha() == 0))
+        m_guiDirty |= DirtyStrokeGeom;
+    m_strokeColor = color;
+    m_guiDirty |= DirtyStrokeColor;
+}
+
+void QQuickPathStencilRenderer::setStrokeWidth(qreal w)
+{
+    m_pen.setWidthF(w);
+    m_guiDirty |= DirtyStrokeGeom;
+}
+
+void QQuickPathStencilRenderer::setFlags(RenderFlags)
+{
+    // antialiasing is up to multisampling
+}
+
+void QQuickPathStencilRenderer::setJoinStyle(QQuickPathItem::JoinStyle joinStyle, int miterLimit)
+{
+    m_pen.setJoinStyle(Qt::PenJoinStyle(joinStyle));
+    m_pen.setMiterLimit(miterLimit);
+    m_guiDirty |= DirtyStrokeGeom;
+}
+
+void QQuickPathStencilRenderer::setCapStyle(QQuickPathItem::CapStyle capStyle)
+{
+    m_pen.setCapStyle(Qt::PenCapStyle(capStyle));
+    m_guiDirty |= DirtyStrokeGeom;
+}
+
+void QQuickPathStencilRenderer::setStrokeStyle(QQuickPathItem::StrokeStyle strokeStyle,
+                                               qreal dashOffset, const QVector<qreal> &dashPattern,
+                                               bool cosmeticStroke)
+{
+    m_pen.setStyle(Qt::PenStyle(strokeStyle));
+    if (strokeStyle == QQuickPathItem::DashLine) {
+        m_pen.setDashPattern(dashPattern);
+        m_pen.setDashOffset(dashOffset);
+    }
+    m_pen.setCosmetic(cosmeticStroke);
+    m_guiDirty |= DirtyStrokeGeom;
+}
+
+static inline void appendFan(const QPolygonF &contour, qreal invScale,
+                             QQuickPathStencilRenderer::VertexContainer *vertices)
+{
+    const int n = contour.count();
+    if (n < 3)
+        return;
+    const QPointF &p0(contour.at(0));
+    int idx = vertices->count();
+    vertices->resize(idx + (n - 2) * 3);
+    QSGGeometry::Point2D *v = vertices->data();
+    for (int i = 1; i < n - 1; ++i) {
+        v[idx++].set(p0.x() * invScale, p0.y() * invScale);
+        v[idx++].set(contour.at(i).x() * invScale, contour.at(i).y() * invScale);
+        v[idx++].set(contour.at(i + 1).x() * invScale, contour.at(i + 1).y() * invScale);
+    }
+}
+
+void QQuickPathStencilRenderer::generateFillFans(const QPainterPath &path, qreal scale,
+                                                 VertexContainer *vertices, QRectF *bounds)
+{
+    vertices->clear();
+    *bounds = QRectF();
+
+    // QBezier flattens to within half a unit, so work in a space scaled
+    // accordingly.
+    const qreal s = scale * 0.5 / CURVE_TOLERANCE;
+    const qreal invScale = 1 / s;
+
+    // Each contour is fanned out from its first point. The fan's triangles
+    // overlap and have mixed orientations, the stencil sorts that out.
+    QPolygonF contour;
+    const int count = path.elementCount();
+    for (int i = 0; i < count; ++i) {
+        const QPainterPath::Element &e = path.elementAt(i);
+        const QPointF pt = QPointF(e.x, e.y) * s;
+        switch (e.type) {
+        case QPainterPath::MoveToElement:
+            appendFan(contour, invScale, vertices);
+            contour.clear();
+            contour.append(pt);
+            break;
+        case QPainterPath::LineToElement:
+            contour.append(pt);
+            break;
+        case QPainterPath::CurveToElement: {
+            const QPainterPath::Element &c2 = path.elementAt(i + 1);
+            const QPainterPath::Element &ep = path.elementAt(i + 2);
+            QBezier::fromPoints(contour.isEmpty() ? pt : contour.last(), pt,
+                                QPointF(c2.x, c2.y) * s, QPointF(ep.x, ep.y) * s).addToPolygon(&contour);
+            i += 2;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    appendFan(contour, invScale, vertices);
+
+    if (!vertices->isEmpty()) {
+        const QSGGeometry::Point2D *v = vertices->constData();
+        float x0 = v[0].x, y0 = v[0].y, x1 = x0, y1 = y0;
+        for (int i = 1; i < vertices->count(); ++i) {
+            x0 = qMin(x0, v[i].x);
+            y0 = qMin(y0, v[i].y);
+            x1 = qMax(x1, v[i].x);
+            y1 = qMax(y1, v[i].y);
+        }
+        *bounds = QRectF(x0, y0, x1 - x0, y1 - y0);
+    }
+}
+
+void QQuickPathStencilRenderer::endSync(bool)
+{
+    if (m_guiDirty & DirtyFillGeom)
+        generateFillFans(m_path, m_scale, &m_fillVertices, &m_fillBounds);
+
+    if (m_guiDirty & DirtyStrokeGeom) {
+        m_strokeVertices.clear();
+        m_strokeBounds = QRectF();
+        if (!m_path.isEmpty() && !qFuzzyIsNull(m_pen.widthF()) && m_strokeColor.alpha()) {
+            QQuickPathRenderer::VertexContainer strip;
+            const QQuickPathRenderer::Color4ub noColor = { 0, 0, 0, 0 };
+            const QSizeF clipSize(m_item->width(), m_item->height());
+            const QPainterPath strokePath = QQuickPathRenderer::trimPath(m_path, m_trimStart, m_trimEnd);
+            QQuickPathRenderer::triangulateStroke(qtVectorPathForPath(strokePath), m_pen, noColor, &strip,
+                                                  clipSize, nullptr, m_scale);
+            m_strokeVertices.resize(strip.count());
+            QSGGeometry::Point2D *v = m_strokeVertices.data();
+            float x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+            for (int i = 0; i < strip.count(); ++i) {
+                const QSGGeometry::ColoredPoint2D &p(strip.at(i));
+                v[i].set(p.x, p.y);
+                if (i == 0) {
+                    x0 = x1 = p.x;
+                    y0 = y1 = p.y;
+                } else {
+                    x0 = qMin(x0, p.x);
+                    y0 = qMin(y0, p.y);
+                    x1 = qMax(x1, p.x);
+                    y1 = qMax(y1, p.y);
+                }
+            }
+            if (!strip.isEmpty())
+                m_strokeBounds = QRectF(x0, y0, x1 - x0, y1 - y0);
+        }
+    }
+
+    m_renderDirty |= m_guiDirty;
+}
+
+void QQuickPathStencilRenderer::updatePathRenderNode()
+{
+    if (!m_renderDirty || !m_node)
+        return;
+
+    if (m_renderDirty & DirtyFillGeom) {
+        m_node->m_fillVertices = m_fillVertices;
+        m_node->m_fillBounds = m_fillBounds;
+        m_node->m_bufferDirty = true;
+    }
+    if (m_renderDirty & (DirtyFillGeom | DirtyFillRule))
+        m_node->m_fillRule = m_path.fillRule();
+    if (m_renderDirty & DirtyStrokeGeom) {
+        m_node->m_strokeVertices = m_strokeVertices;
+        m_node->m_strokeBounds = m_strokeBounds;
+        m_node->m_bufferDirty = true;
+    }
+    if (m_renderDirty & DirtyFillColor) {
+        m_node->m_fillColor = m_fillColor;
+        m_node->m_fillGradientActive = m_fillGradientActive;
+        m_node->m_fillGradient = m_fillGradient;
+        m_node->m_fillGradientTable = m_fillGradientTable;
+        m_node->m_gradientRowDirty = true;
+    }
+    if (m_renderDirty & DirtyStrokeColor)
+        m_node->m_strokeColor = m_strokeColor;
+
+    m_node->markDirty(QSGNode::DirtyMaterial);
+    m_renderDirty = 0;
+}
+
+QQuickPathStencilRenderNode::QQuickPathStencilRenderNode(QQuickItem *item)
+    : m_item(item),
+      m_fillRule(Qt::OddEvenFill),
+      m_fillGradientActive(false),
+      m_gradientRow(-1),
+      m_gradientRowDirty(true),
+      m_bufferDirty(true),
+      m_buffer(QOpenGLBuffer::VertexBuffer),
+      m_colorProgram(nullptr),
+      m_gradientProgram(nullptr)
+{
+}
+
+QQuickPathStencilRenderNode::~QQuickPathStencilRenderNode()
+{
+    releaseResources();
+}
+
+void QQuickPathStencilRenderNode::releaseResources()
+{
+    delete m_colorProgram;
+    m_colorProgram = nullptr;
+    delete m_gradientProgram;
+    m_gradientProgram = nullptr;
+    if (m_gradientRow >= 0 && QOpenGLContext::currentContext())
+        QQuickPathGradientCache::currentCache()->releaseRow(m_gradientRow);
+    m_gradientRow = -1;
+    m_gradientRowDirty = true;
+    m_buffer.destroy();
+    m_bufferDirty = true;
+}
+
+static QOpenGLShaderProgram *createProgram(const QString &fragmentShader)
+{
+    QOpenGLShaderProgram *program = new QOpenGLShaderProgram;
+    program->addShaderFromSourceFile(QOpenGLShader::Vertex,
+                                     QStringLiteral(":/qt-project.org/scenegraph/path/shaders/stencil.vert"));
+    program->addShaderFromSourceFile(QOpenGLShader::Fragment, fragmentShader);
+    program->bindAttributeLocation("vertexCoord", 0);
+    if (!program->link())
+        qWarning("Failed to link stencil-then-cover shader: %s", qPrintable(program->log()));
+    return program;
+}
+
+static inline void appendRect(QSGGeometry::Point2D *v, const QRectF &r)
+{
+    v[0].set(r.left(), r.top());
+    v[1].set(r.right(), r.top());
+    v[2].set(r.left(), r.bottom());
+    v[3].set(r.right(), r.bottom());
+}
+
+void QQuickPathStencilRenderNode::drawRect(int index)
+{
+    QOpenGLContext::currentContext()->functions()->glDrawArrays(GL_TRIANGLE_STRIP, index * 4, 4);
+}
+
+// Draws the given rectangle where the stencil has a non-zero count and
+// resets the count.
+void QQuickPathStencilRenderNode::cover(int rectIndex, const QColor &color,
+                                        const QQuickPathRenderer::GradientDesc *gradient,
+                                        const QMatrix4x4 &matrix)
+{
+    QOpenGLFunctions *f = QOpenGLContext::currentContext()->functions();
+
+    QOpenGLShaderProgram *program = gradient ? m_gradientProgram : m_colorProgram;
+    program->bind();
+    program->setUniformValue("matrix", matrix);
+    if (gradient) {
+        program->setUniformValue("gradStart", gradient->start);
+        program->setUniformValue("gradEnd", gradient->end);
+        program->setUniformValue("opacity", float(inheritedOpacity()));
+        QQuickPathGradientCache *cache = QQuickPathGradientCache::currentCache();
+        if (m_gradientRowDirty) {
+            const int row = cache->acquireRow(m_fillGradientTable);
+            cache->releaseRow(m_gradientRow);
+            m_gradientRow = row;
+            m_gradientRowDirty = false;
+        }
+        const int page = cache->pageOf(m_gradientRow);
+        f->glActiveTexture(GL_TEXTURE0);
+        cache->bind(page);
+        program->setUniformValue("gradTabRow", float((cache->rowInPage(m_gradientRow) + 0.5) / cache->textureRows(page)));
+        program->setUniformValue("gradRepeat", gradient->spread == QQuickPathGradient::RepeatSpread ? 1.0f : 0.0f);
+    } else {
+        const float o = color.alphaF() * inheritedOpacity();
+        program->setUniformValue("color", QVector4D(color.redF() * o, color.greenF() * o, color.blueF() * o, o));
+    }
+
+    f->glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    f->glEnable(GL_BLEND);
+    f->glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    f->glStencilMask(0xFF);
+    f->glStencilFunc(GL_LESS, INSIDE_BIT, 0xFF); // inside and count != 0
+    f->glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+    drawRect(rectIndex);
+
+    f->glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    f->glDisable(GL_BLEND);
+    m_colorProgram->bind();
+}
+
+void QQuickPathStencilRenderNode::render(const RenderState *state)
+{
+    if (m_fillVertices.isEmpty() && m_strokeVertices.isEmpty())
+        return;
+
+    QOpenGLFunctions *f = QOpenGLContext::currentContext()->functions();
+
+    if (!m_colorProgram) {
+        m_colorProgram = createProgram(QStringLiteral(":/qt-project.org/scenegraph/path/shaders/stencilcolor.frag"));
+        m_gradientProgram = createProgram(QStringLiteral(":/qt-project.org/scenegraph/path/shaders/stencilgradient.frag"));
+    }
+
+    if (!m_buffer.isCreated()) {
+        m_buffer.create();
+        m_bufferDirty = true;
+    }
+    m_buffer.bind();
+    if (m_bufferDirty) {
+        const int vertexCount = RectCount * 4 + m_fillVertices.count() + m_strokeVertices.count();
+        QVector<QSGGeometry::Point2D> data(vertexCount);
+        QSGGeometry::Point2D *v = data.data();
+        appendRect(v + BoundsRect * 4, m_fillBounds.united(m_strokeBounds));
+        appendRect(v + FillRect * 4, m_fillBounds);
+        appendRect(v + StrokeRect * 4, m_strokeBounds);
+        v += RectCount * 4;
+        memcpy(v, m_fillVertices.constData(), m_fillVertices.count() * sizeof(QSGGeometry::Point2D));
+        v += m_fillVertices.count();
+        memcpy(v, m_strokeVertices.constData(), m_strokeVertices.count() * sizeof(QSGGeometry::Point2D));
+        m_buffer.allocate(data.constData(), vertexCount * sizeof(QSGGeometry::Point2D));
+        m_bufferDirty = false;
+    }
+
+    const QMatrix4x4 matrix = *state->projectionMatrix() * *this->matrix();
+    m_colorProgram->bind();
+    m_colorProgram->setUniformValue("matrix", matrix);
+    f->glEnableVertexAttribArray(0);
+    f->glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    f->glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    f->glDisable(GL_BLEND);
+    f->glEnable(GL_STENCIL_TEST);
+
+    // Mark the pixels inside the clip, the scenegraph's clip value is
+    // restored at the end.
+    const GLint clipValue = state->stencilEnabled() ? state->stencilValue() : 0;
+    if (state->stencilEnabled()) {
+        f->glStencilMask(0xFF);
+        f->glStencilFunc(GL_NOTEQUAL, clipValue, 0xFF);
+        f->glStencilOp(GL_KEEP, GL_KEEP, GL_ZERO);
+        drawRect(BoundsRect);
+        f->glStencilMask(INSIDE_BIT);
+        f->glStencilFunc(GL_EQUAL, clipValue, 0xFF);
+        f->glStencilOp(GL_KEEP, GL_KEEP, GL_INVERT);
+        drawRect(BoundsRect);
+        f->glStencilMask(COUNT_BITS);
+        f->glStencilFunc(GL_ALWAYS, 0, 0xFF);
+        f->glStencilOp(GL_KEEP, GL_KEEP, GL_ZERO);
+        drawRect(BoundsRect);
+    } else {
+        f->glStencilMask(0xFF);
+        f->glStencilFunc(GL_ALWAYS, INSIDE_BIT, 0xFF);
+        f->glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+        drawRect(BoundsRect);
+    }
+
+    int first = RectCount * 4;
+    if (!m_fillVertices.isEmpty()) {
+        f->glStencilMask(COUNT_BITS);
+        f->glStencilFunc(GL_ALWAYS, 0, 0xFF);
+        if (m_fillRule == Qt::OddEvenFill) {
+            f->glStencilOp(GL_KEEP, GL_KEEP, GL_INVERT);
+        } else {
+            f->glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_KEEP, GL_INCR_WRAP);
+            f->glStencilOpSeparate(GL_BACK, GL_KEEP, GL_KEEP, GL_DECR_WRAP);
+        }
+        f->glDrawArrays(GL_TRIANGLES, first, m_fillVertices.count());
+        cover(FillRect, m_fillColor, m_fillGradientActive ? &m_fillGradient : nullptr, matrix);
+        first += m_fillVertices.count();
+    }
+
+    if (!m_strokeVertices.isEmpty()) {
+        f->glStencilMask(COUNT_BITS);
+        f->glStencilFunc(GL_ALWAYS, 1, 0xFF);
+        f->glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+        f->glDrawArrays(GL_TRIANGLE_STRIP, first, m_strokeVertices.count());
+        cover(StrokeRect, m_strokeColor, nullptr, matrix);
+    }
+
+    // restore
+    f->glStencilMask(0xFF);
+    if (state->stencilEnabled()) {
+        f->glStencilFunc(GL_GREATER, INSIDE_BIT, 0xFF); // outside
+        f->glStencilOp(GL_KEEP, GL_KEEP, GL_ZERO);
+        drawRect(BoundsRect);
+        f->glStencilFunc(GL_LESS, clipValue, 0xFF); // inside
+        f->glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+        drawRect(BoundsRect);
+    } else {
+        f->glStencilFunc(GL_ALWAYS, 0, 0xFF);
+        f->glStencilOp(GL_KEEP, GL_KEEP, GL_ZERO);
+        drawRect(BoundsRect);
+    }
+
+    f->glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    f->glDisableVertexAttribArray(0);
+    m_buffer.release();
+    m_colorProgram->release();
+}
+
+QSGRenderNode::StateFlags QQuickPathStencilRenderNode::changedStates() const
+{
+    return BlendState | StencilState | ColorState;
+}
+
+QSGRenderNode::RenderingFlags QQuickPathStencilRenderNode::flags() const
+{
+    return BoundedRectRendering;
+}
+
+QRectF QQuickPathStencilRenderNode::rect() const
+{
+    return m_fillBounds.united(m_strokeBounds);
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_OPENGL
@@ -0,0 +1,189 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtQuickPath module
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QQUICKPATHSTENCILRENDERER_P_H
+#define QQUICKPATHSTENCILRENDERER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of a number of Qt sources files.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qquickabstractpathrenderer_p.h"
+#include "qquickpathrendernode_p.h"
+#include <qsgrendernode.h>
+#include <qsggeometry.h>
+#include <QPen>
+#include <QOpenGLBuffer>
+
+#ifndef QT_NO_OPENGL
+
+QT_BEGIN_NAMESPACE
+
+class QQuickPathStencilRenderNode;
+class QOpenGLShaderProgram;
+
+// Fills by rendering the winding number (or its parity) of a triangle fan per
+// contour into the stencil buffer and then covering the bounding rectangle
+// where the stencil is non-zero. There is no triangulation involved, a path
+// change costs O(n). Strokes come from QTriangulatingStroker and go through
+// the stencil as well, so that overlapping parts are not blended twice.
+// Requires a stencil buffer, there is no antialiasing unless multisampling.
+class QQUICKPATH_EXPORT QQuickPathStencilRenderer : public QQuickAbstractPathRenderer
+{
+public:
+    enum Dirty {
+        DirtyFillGeom = 0x01,
+        DirtyStrokeGeom = 0x02,
+        DirtyFillColor = 0x04,
+        DirtyStrokeColor = 0x08,
+        DirtyFillRule = 0x10
+    };
+
+    typedef QVector<QSGGeometry::Point2D> VertexContainer;
+
+    QQuickPathStencilRenderer(QQuickItem *item)
+        : m_item(item),
+          m_node(nullptr),
+          m_guiDirty(0),
+          m_renderDirty(0),
+          m_scale(1),
+          m_trimStart(0),
+          m_trimEnd(1),
+          m_fillGradientActive(false)
+    { }
+
+    void setNode(QQuickPathStencilRenderNode *node);
+
+    Capabilities capabilities() const override { return ScaleDependent; }
+
+    void beginSync() override;
+    void setPath(const QPainterPath &path) override;
+    void setFillRule(Qt::FillRule fillRule) override;
+    void setScale(qreal scale) override;
+    void setStrokeTrim(qreal start, qreal end) override;
+    void setFillColor(const QColor &color, QQuickPathGradient *gradient) override;
+    void setStrokeColor(const QColor &color) override;
+    void setStrokeWidth(qreal w) override;
+    void setFlags(RenderFlags flags) override;
+    void setJoinStyle(QQuickPathItem::JoinStyle joinStyle, int miterLimit) override;
+    void setCapStyle(QQuickPathItem::CapStyle capStyle) override;
+    void setStrokeStyle(QQuickPathItem::StrokeStyle strokeStyle,
+                        qreal dashOffset, const QVector<qreal> &dashPattern,
+                        bool cosmeticStroke) override;
+    void endSync(bool async) override;
+    void updatePathRenderNode() override;
+
+    // Triangle fans for all contours, as a list of triangles. Safe to call
+    // from any thread.
+    static void generateFillFans(const QPainterPath &path, qreal scale,
+                                 VertexContainer *vertices, QRectF *bounds);
+
+private:
+    QQuickItem *m_item;
+    QQuickPathStencilRenderNode *m_node;
+    int m_guiDirty;
+    int m_renderDirty;
+    qreal m_scale;
+    qreal m_trimStart;
+    qreal m_trimEnd;
+
+    QPainterPath m_path;
+    QPen m_pen;
+    QColor m_fillColor;
+    QColor m_strokeColor;
+    bool m_fillGradientActive;
+    QQuickPathRenderer::GradientDesc m_fillGradient;
+    QQuickPathRenderer::GradientTable m_fillGradientTable;
+
+    VertexContainer m_fillVertices;
+    QRectF m_fillBounds;
+    VertexContainer m_strokeVertices;
+    QRectF m_strokeBounds;
+};
+
+class QQuickPathStencilRenderNode : public QSGRenderNode
+{
+public:
+    QQuickPathStencilRenderNode(QQuickItem *item);
+    ~QQuickPathStencilRenderNode();
+
+    void render(const RenderState *state) override;
+    void releaseResources() override;
+    StateFlags changedStates() const override;
+    RenderingFlags flags() const override;
+    QRectF rect() const override;
+
+private:
+    void drawRect(int index);
+    void cover(int rectIndex, const QColor &color, const QQuickPathRenderer::GradientDesc *gradient,
+               const QMatrix4x4 &matrix);
+
+    QQuickItem *m_item;
+
+    QQuickPathStencilRenderer::VertexContainer m_fillVertices;
+    QRectF m_fillBounds;
+    Qt::FillRule m_fillRule;
+    QColor m_fillColor;
+    bool m_fillGradientActive;
+    QQuickPathRenderer::GradientDesc m_fillGradient;
+    QQuickPathRenderer::GradientTable m_fillGradientTable;
+    // the fill gradient's row in the gradient cache, -1 when none
+    int m_gradientRow;
+    bool m_gradientRowDirty;
+    QQuickPathStencilRenderer::VertexContainer m_strokeVertices;
+    QRectF m_strokeBounds;
+    QColor m_strokeColor;
+
+    bool m_bufferDirty;
+    QOpenGLBuffer m_buffer;
+    QOpenGLShaderProgram *m_colorProgram;
+    QOpenGLShaderProgram *m_gradientProgram;
+
+    friend class QQuickPathStencilRenderer;
+};
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_OPENGL
+
+#endif
@@ -0,0 +1,407 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtQuickPath module
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qquickpathsvgparser_p.h"
+#include <qmath.h>
+#include <cmath>
+
+QT_BEGIN_NAMESPACE
+
+// the powers of ten that are exact as doubles
+static const double powersOf10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+namespace {
+
+class Scanner
+{
+public:
+    Scanner(const QChar *str, int length)
+        : m_pos(reinterpret_cast<const ushort *>(str)),
+          m_end(m_pos + length)
+    { }
+
+    bool atEnd() const { return m_pos == m_end; }
+    ushort peek() const { return *m_pos; }
+    void advance() { ++m_pos; }
+
+    static bool isSpace(ushort c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f'; }
+    static bool isDigit(ushort c) { return c >= '0' && c <= '9'; }
+
+    void skipSpace()
+    {
+        while (m_pos != m_end && isSpace(*m_pos))
+            ++m_pos;
+    }
+
+    // whitespace with at most one comma in it
+    void skipSeparator()
+    {
+        skipSpace();
+        if (m_pos != m_end && *m_pos == ',') {
+            ++m_pos;
+            skipSpace();
+        }
+    }
+
+    bool number(qreal *value);
+    bool numbers(qreal *values, int count);
+    bool flag(bool *value);
+
+private:
+    const ushort *m_pos;
+    const ushort *m_end;
+};
+
+// Collects up to 19 significant digits in an integer and scales that with
+// the decimal exponent. Within the range of the table above this is exact
+// up to the rounding of the result, which is plenty for coordinates.
+bool Scanner::number(qreal *value)
+{
+    const ushort *p = m_pos;
+    bool negative = false;
+    if (p != m_end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+
+    quint64 mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool any = false;
+    for (; p != m_end && isDigit(*p); ++p) {
+        any = true;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa)
+                ++digits;
+        } else {
+            ++exponent;
+        }
+    }
+    if (p != m_end && *p == '.') {
+        for (++p; p != m_end && isDigit(*p); ++p) {
+            any = true;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa)
+                    ++digits;
+                --exponent;
+            }
+        }
+    }
+    if (!any)
+        return false;
+
+    // an 'e' without digits after it is not part of the number
+    if (p != m_end && (*p == 'e' || *p == 'E')) {
+        const ushort *q = p + 1;
+        bool negativeExponent = false;
+        if (q != m_end && (*q == '-' || *q == '+')) {
+            negativeExponent = *q == '-';
+            ++q;
+        }
+        if (q != m_end && isDigit(*q)) {
+            int e = 0;
+            for (; q != m_end && isDigit(*q); ++q) {
+                if (e < 10000)
+                    e = e * 10 + (*q - '0');
+            }
+            exponent += negativeExponent ? -e : e;
+            p = q;
+        }
+    }
+    m_pos = p;
+
+    double v = double(mantissa);
+    if (mantissa && exponent) {
+        if (exponent > 0 && exponent <= 22)
+            v *= powersOf10[exponent];
+        else if (exponent < 0 && exponent >= -22)
+            v /= powersOf10[-exponent];
+        else
+            v *= std::pow(10.0, exponent);
+    }
+    *value = negative ? -v : v;
+    return true;
+}
+
+bool Scanner::numbers(qreal *values, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        if (!number(values + i))
+            return false;
+        skipSeparator();
+    }
+    return true;
+}
+
+// arc flags are a single digit and need no separator after them
+bool Scanner::flag(bool *value)
+{
+    if (m_pos == m_end || (*m_pos != '0' && *m_pos != '1'))
+        return false;
+    *value = *m_pos == '1';
+    ++m_pos;
+    skipSeparator();
+    return true;
+}
+
+}
+
+// Endpoint to center parameterization as described in the implementation
+// notes of the SVG specification, followed by one cubic per quarter turn.
+static void arcTo(QPainterPath *path, const QPointF &from, qreal rx, qreal ry, qreal angle,
+                  bool largeArc, bool sweep, const QPointF &to)
+{
+    if (from == to)
+        return;
+    rx = qAbs(rx);
+    ry = qAbs(ry);
+    if (qFuzzyIsNull(rx) || qFuzzyIsNull(ry)) {
+        path->lineTo(to);
+        return;
+    }
+
+    const qreal phi = qDegreesToRadians(angle);
+    const qreal cosPhi = qCos(phi);
+    const qreal sinPhi = qSin(phi);
+    const qreal dx = (from.x() - to.x()) / 2;
+    const qreal dy = (from.y() - to.y()) / 2;
+    const qreal x1 = cosPhi * dx + sinPhi * dy;
+    const qreal y1 = -sinPhi * dx + cosPhi * dy;
+
+    // radii too small to connect the points get scaled up
+    const qreal lambda = (x1 * x1) / (rx * rx) + (y1 * y1) / (ry * ry);
+    if (lambda > 1) {
+        const qreal s = qSqrt(lambda);
+        rx *= s;
+        ry *= s;
+    }
+
+    const qreal rx2 = rx * rx;
+    const qreal ry2 = ry * ry;
+    const qreal num = rx2 * ry2 - rx2 * y1 * y1 - ry2 * x1 * x1;
+    const qreal den = rx2 * y1 * y1 + ry2 * x1 * x1;
+    qreal coef = num > 0 ? qSqrt(num / den) : 0;
+    if (largeArc == sweep)
+        coef = -coef;
+    const qreal cx1 = coef * rx * y1 / ry;
+    const qreal cy1 = -coef * ry * x1 / rx;
+    const qreal cx = cosPhi * cx1 - sinPhi * cy1 + (from.x() + to.x()) / 2;
+    const qreal cy = sinPhi * cx1 + cosPhi * cy1 + (from.y() + to.y()) / 2;
+
+    const qreal theta = qAtan2((y1 - cy1) / ry, (x1 - cx1) / rx);
+    qreal delta = qAtan2((-y1 - cy1) / ry, (-x1 - cx1) / rx) - theta;
+    if (sweep && delta < 0)
+        delta += 2 * M_PI;
+    else if (!sweep && delta > 0)
+        delta -= 2 * M_PI;
+
+    const int segments = qMax(1, qCeil(qAbs(delta) / M_PI_2 - 0.001));
+    const qreal step = delta / segments;
+    const qreal t = 4.0 / 3.0 * qTan(step / 4);
+    const auto map = [&](qreal x, qreal y) {
+        return QPointF(cx + rx * x * cosPhi - ry * y * sinPhi, cy + rx * x * sinPhi + ry * y * cosPhi);
+    };
+    qreal a = theta;
+    qreal cosA = qCos(a);
+    qreal sinA = qSin(a);
+    for (int i = 0; i < segments; ++i) {
+        a += step;
+        const qreal cosB = qCos(a);
+        const qreal sinB = qSin(a);
+        path->cubicTo(map(cosA - t * sinA, sinA + t * cosA),
+                      map(cosB + t * sinB, sinB - t * cosB),
+                      i == segments - 1 ? to : map(cosB, sinB));
+        cosA = cosB;
+        sinA = sinB;
+    }
+}
+
+// Where z returns to when the data continues a path, the last moveto.
+// QPainterPath starts a new subpath at the current position after a close.
+static QPointF subpathStart(const QPainterPath &path)
+{
+    for (int i = path.elementCount() - 1; i >= 0; --i) {
+        const QPainterPath::Element &e = path.elementAt(i);
+        if (e.isMoveTo())
+            return e;
+    }
+    return QPointF();
+}
+
+bool QQuickPathSvgParser::parse(const QString &str, QPainterPath *path)
+{
+    return parse(str.constData(), str.size(), path);
+}
+
+bool QQuickPathSvgParser::parse(const QChar *str, int length, QPainterPath *path)
+{
+    Scanner s(str, length);
+    // relative coordinates continue from where path is at, and so does z
+    QPointF current = path->currentPosition();
+    QPointF start = subpathStart(*path);
+    // the control point s and t reflect, when the previous segment was of
+    // the matching kind
+    enum { NoCurve, Cubic, Quad } lastCurve = NoCurve;
+    QPointF control;
+    ushort command = 0;
+    qreal v[5];
+
+    s.skipSpace();
+    while (!s.atEnd()) {
+        const ushort c = s.peek();
+        if (!Scanner::isDigit(c) && c != '.' && c != '-' && c != '+') {
+            command = c;
+            s.advance();
+            s.skipSpace();
+        } else if (command == 0 || command == 'z' || command == 'Z') {
+            return false;
+        } else if (command == 'M') {
+            // coordinates after a moveto are lines
+            command = 'L';
+        } else if (command == 'm') {
+            command = 'l';
+        }
+        if (path->elementCount() == 0 && command != 'M' && command != 'm')
+            return false;
+
+        const bool relative = command >= 'a';
+        const QPointF base = relative ? current : QPointF();
+        switch (command) {
+        case 'M':
+        case 'm':
+            if (!s.numbers(v, 2))
+                return false;
+            current = base + QPointF(v[0], v[1]);
+            start = current;
+            path->moveTo(current);
+            lastCurve = NoCurve;
+            break;
+        case 'L':
+        case 'l':
+            if (!s.numbers(v, 2))
+                return false;
+            current = base + QPointF(v[0], v[1]);
+            path->lineTo(current);
+            lastCurve = NoCurve;
+            break;
+        case 'H':
+        case 'h':
+            if (!s.numbers(v, 1))
+                return false;
+            current.setX(base.x() + v[0]);
+            path->lineTo(current);
+            lastCurve = NoCurve;
+            break;
+        case 'V':
+        case 'v':
+            if (!s.numbers(v, 1))
+                return false;
+            current.setY(base.y() + v[0]);
+            path->lineTo(current);
+            lastCurve = NoCurve;
+            break;
+        case 'C':
+        case 'c': {
+            if (!s.numbers(v, 6))
+                return false;
+            const QPointF c1 = base + QPointF(v[0], v[1]);
+            control = base + QPointF(v[2], v[3]);
+            current = base + QPointF(v[4], v[5]);
+            path->cubicTo(c1, control, current);
+            lastCurve = Cubic;
+            break;
+        }
+        case 'S':
+        case 's': {
+            if (!s.numbers(v, 4))
+                return false;
+            const QPointF c1 = lastCurve == Cubic ? 2 * current - control : current;
+            control = base + QPointF(v[0], v[1]);
+            current = base + QPointF(v[2], v[3]);
+            path->cubicTo(c1, control, current);
+            lastCurve = Cubic;
+            break;
+        }
+        case 'Q':
+        case 'q':
+            if (!s.numbers(v, 4))
+                return false;
+            control = base + QPointF(v[0], v[1]);
+            current = base + QPointF(v[2], v[3]);
+            path->quadTo(control, current);
+            lastCurve = Quad;
+            break;
+        case 'T':
+        case 't':
+            if (!s.numbers(v, 2))
+                return false;
+            control = lastCurve == Quad ? 2 * current - control : current;
+            current = base + QPointF(v[0], v[1]);
+            path->quadTo(control, current);
+            lastCurve = Quad;
+            break;
+        case 'A':
+        case 'a': {
+            bool largeArc;
+            bool sweep;
+            if (!s.numbers(v, 3) || !s.flag(&largeArc) || !s.flag(&sweep) || !s.numbers(v + 3, 2))
+                return false;
+            const QPointF to = base + QPointF(v[3], v[4]);
+            arcTo(path, current, v[0], v[1], v[2], largeArc, sweep, to);
+            current = to;
+            lastCurve = NoCurve;
+            break;
+        }
+        case 'Z':
+        case 'z':
+            path->closeSubpath();
+            current = start;
+            lastCurve = NoCurve;
+            break;
+        default:
+            return false;
+        }
+        s.skipSpace();
+    }
+    return true;
+}
+
+QT_END_NAMESPACE
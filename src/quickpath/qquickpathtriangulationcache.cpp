@@ -0,0 +1,263 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtQuickPath module
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qquickpathtriangulationcache_p.h"
+#include <QtCore/qglobalstatic.h>
+
+QT_BEGIN_NAMESPACE
+
+// default budget when QT_QUICKPATH_TRIANGULATION_CACHE_SIZE (in kilobytes) is not set
+static const int DEFAULT_MAX_BYTES = 8 * 1024 * 1024;
+
+Q_GLOBAL_STATIC(QQuickPathTriangulationCache, qt_path_triangulation_cache)
+
+quint64 QQuickPathTriangulationCache::pathHash(const QPainterPath &path)
+{
+    quint64 h = hashSeed();
+    hashWord(&h, path.fillRule());
+    const int count = path.elementCount();
+    hashWord(&h, count);
+    for (int i = 0; i < count; ++i) {
+        const QPainterPath::Element &e = path.elementAt(i);
+        hashWord(&h, e.type);
+        hashReal(&h, e.x);
+        hashReal(&h, e.y);
+    }
+    return h;
+}
+
+bool QQuickPathTriangulationCache::Key::operator==(const Key &other) const
+{
+    if (kind != other.kind || hash != other.hash || elementIndexUint != other.elementIndexUint
+            || antialiasing != other.antialiasing || curves != other.curves || scale != other.scale)
+        return false;
+    if (kind == Stroke && (pen != other.pen || clipSize != other.clipSize))
+        return false;
+    return path == other.path;
+}
+
+QQuickPathTriangulationCache::QQuickPathTriangulationCache()
+    : m_hits(0),
+      m_misses(0)
+{
+    bool ok = false;
+    const int kb = qEnvironmentVariableIntValue("QT_QUICKPATH_TRIANGULATION_CACHE_SIZE", &ok);
+    m_cache.setMaxCost(ok ? qMax(0, kb) * 1024 : DEFAULT_MAX_BYTES);
+}
+
+QQuickPathTriangulationCache *QQuickPathTriangulationCache::instance()
+{
+    return qt_path_triangulation_cache();
+}
+
+QQuickPathTriangulationCache::Key QQuickPathTriangulationCache::fillKey(const QPainterPath &path,
+                                                                       bool elementIndexUint,
+                                                                       bool antialiasing,
+                                                                       bool curves,
+                                                                       qreal scale)
+{
+    Key key;
+    key.kind = Key::Fill;
+    key.path = path;
+    key.elementIndexUint = elementIndexUint;
+    key.antialiasing = antialiasing;
+    key.curves = curves;
+    key.scale = scale;
+    key.hash = pathHash(path);
+    hashWord(&key.hash, elementIndexUint);
+    hashWord(&key.hash, antialiasing);
+    hashWord(&key.hash, curves);
+    hashReal(&key.hash, scale);
+    return key;
+}
+
+QQuickPathTriangulationCache::Key QQuickPathTriangulationCache::strokeKey(const QPainterPath &path,
+                                                                         const QPen &pen,
+                                                                         const QSizeF &clipSize,
+                                                                         bool antialiasing,
+                                                                         qreal scale)
+{
+    Key key;
+    key.kind = Key::Stroke;
+    key.path = path;
+    key.pen = pen;
+    key.clipSize = clipSize;
+    key.antialiasing = antialiasing;
+    key.scale = scale;
+    key.hash = pathHash(path);
+    hashWord(&key.hash, antialiasing);
+    hashReal(&key.hash, scale);
+    hashReal(&key.hash, pen.widthF());
+    hashWord(&key.hash, pen.style());
+    hashWord(&key.hash, pen.capStyle());
+    hashWord(&key.hash, pen.joinStyle());
+    hashReal(&key.hash, pen.miterLimit());
+    hashWord(&key.hash, pen.isCosmetic());
+    if (pen.style() != Qt::SolidLine) {
+        hashReal(&key.hash, pen.dashOffset());
+        const QVector<qreal> pattern = pen.dashPattern();
+        for (qreal v : pattern)
+            hashReal(&key.hash, v);
+    }
+    hashReal(&key.hash, clipSize.width());
+    hashReal(&key.hash, clipSize.height());
+    return key;
+}
+
+bool QQuickPathTriangulationCache::findFill(const Key &key, QQuickPathRenderer::FillGeometry *fill,
+                                            QQuickPathRenderer::FillGeometry *otherFill)
+{
+    QMutexLocker lock(&m_mutex);
+    Entry *e = m_cache.object(key);
+    if (!e || (otherFill && !e->hasOtherFill)) {
+        ++m_misses;
+        return false;
+    }
+    ++m_hits;
+    *fill = e->fill;
+    if (otherFill)
+        *otherFill = e->otherFill;
+    return true;
+}
+
+bool QQuickPathTriangulationCache::findStroke(const Key &key, QQuickPathRenderer::VertexContainer *strokeVertices,
+                                              QQuickPathRenderer::FringeContainer *strokeFringe,
+                                              QQuickPathRenderer::ExtrudedVertexContainer *extrudedStrokeVertices)
+{
+    QMutexLocker lock(&m_mutex);
+    Entry *e = m_cache.object(key);
+    if (!e) {
+        ++m_misses;
+        return false;
+    }
+    ++m_hits;
+    *strokeVertices = e->strokeVertices;
+    *strokeFringe = e->strokeFringe;
+    *extrudedStrokeVertices = e->extrudedStrokeVertices;
+    return true;
+}
+
+static int fillBytes(const QQuickPathRenderer::FillGeometry &fill)
+{
+    return fill.vertices.count() * sizeof(QSGGeometry::ColoredPoint2D)
+           + fill.indices.count() * sizeof(quint32)
+           + fill.ranges.count() * sizeof(QQuickPathRenderer::FillRange)
+           + fill.fringe.count() * sizeof(QQuickPathRenderer::SmoothColoredPoint2D)
+           + fill.curveVertices.count() * sizeof(QQuickPathRenderer::CurveColoredPoint2D);
+}
+
+void QQuickPathTriangulationCache::insertFill(const Key &key, const QQuickPathRenderer::FillGeometry &fill,
+                                              const QQuickPathRenderer::FillGeometry *otherFill)
+{
+    Entry *e = new Entry;
+    e->fill = fill;
+    int bytes = fillBytes(fill);
+    if (otherFill) {
+        e->otherFill = *otherFill;
+        e->hasOtherFill = true;
+        // shared with fill when the rule makes no difference
+        if (otherFill->vertices.constData() != fill.vertices.constData()
+                || otherFill->curveVertices.constData() != fill.curveVertices.constData())
+            bytes += fillBytes(*otherFill);
+    }
+    insert(key, e, bytes);
+}
+
+void QQuickPathTriangulationCache::insertStroke(const Key &key, const QQuickPathRenderer::VertexContainer &strokeVertices,
+                                                const QQuickPathRenderer::FringeContainer &strokeFringe,
+                                                const QQuickPathRenderer::ExtrudedVertexContainer &extrudedStrokeVertices)
+{
+    Entry *e = new Entry;
+    e->strokeVertices = strokeVertices;
+    e->strokeFringe = strokeFringe;
+    e->extrudedStrokeVertices = extrudedStrokeVertices;
+    insert(key, e, strokeVertices.count() * sizeof(QSGGeometry::ColoredPoint2D)
+           + strokeFringe.count() * sizeof(QQuickPathRenderer::SmoothColoredPoint2D)
+           + extrudedStrokeVertices.count() * sizeof(QQuickPathRenderer::ExtrudedColoredPoint2D));
+}
+
+void QQuickPathTriangulationCache::insert(const Key &key, Entry *e, int dataBytes)
+{
+    // the key keeps the path alive, account for that too
+    const int cost = dataBytes + key.path.elementCount() * sizeof(QPainterPath::Element) + sizeof(Entry);
+    QMutexLocker lock(&m_mutex);
+    m_cache.insert(key, e, cost); // deletes e when it does not fit
+}
+
+int QQuickPathTriangulationCache::maxBytes() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_cache.maxCost();
+}
+
+void QQuickPathTriangulationCache::setMaxBytes(int bytes)
+{
+    QMutexLocker lock(&m_mutex);
+    m_cache.setMaxCost(qMax(0, bytes));
+}
+
+int QQuickPathTriangulationCache::totalBytes() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_cache.totalCost();
+}
+
+int QQuickPathTriangulationCache::hits() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_hits;
+}
+
+int QQuickPathTriangulationCache::misses() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_misses;
+}
+
+void QQuickPathTriangulationCache::resetCounters()
+{
+    QMutexLocker lock(&m_mutex);
+    m_hits = 0;
+    m_misses = 0;
+}
+
+void QQuickPathTriangulationCache::clear()
+{
+    QMutexLocker lock(&m_mutex);
+    m_cache.clear();
+}
+
+QT_END_NAMESPACE
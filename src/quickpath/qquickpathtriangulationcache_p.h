@@ -0,0 +1,164 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtQuickPath module
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QQUICKPATHTRIANGULATIONCACHE_P_H
+#define QQUICKPATHTRIANGULATIONCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of a number of Qt sources files.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qquickpathrendernode_p.h"
+#include <QCache>
+#include <QMutex>
+
+QT_BEGIN_NAMESPACE
+
+// Process-wide LRU cache of fill and stroke triangulations. Items with the
+// same geometry (icons, delegates, etc.) share the results this way. The
+// vertex colors are not part of the key, they get corrected when uploading
+// the geometry to the nodes. The stored data is never modified, lookups
+// return implicitly shared copies.
+class QQUICKPATH_EXPORT QQuickPathTriangulationCache
+{
+public:
+    struct Key {
+        enum Kind { Fill, Stroke };
+        Key() : kind(Fill), hash(0), elementIndexUint(false), antialiasing(false), curves(false), scale(1) { }
+        Kind kind;
+        quint64 hash;
+        QPainterPath path;
+        QPen pen;
+        QSizeF clipSize;
+        bool elementIndexUint;
+        bool antialiasing;
+        bool curves;
+        qreal scale;
+        bool operator==(const Key &other) const;
+    };
+
+    QQuickPathTriangulationCache();
+
+    static QQuickPathTriangulationCache *instance();
+
+    static Key fillKey(const QPainterPath &path, bool elementIndexUint, bool antialiasing,
+                       bool curves, qreal scale);
+    static Key strokeKey(const QPainterPath &path, const QPen &pen, const QSizeF &clipSize,
+                         bool antialiasing, qreal scale);
+    // the hash the keys are based on, covering the fill rule and all elements
+    static quint64 pathHash(const QPainterPath &path);
+
+    // 64-bit FNV-1a over whole words, with each word mixed first. Unlike
+    // qHash() this depends on every coordinate and the collision probability
+    // is low enough to not matter for typical scenes. Equal hashes are still
+    // verified by comparing the keys. Start with hashSeed().
+    static quint64 hashSeed() { return Q_UINT64_C(0xcbf29ce484222325); }
+    static void hashWord(quint64 *h, quint64 v)
+    {
+        v ^= v >> 33;
+        v *= Q_UINT64_C(0xff51afd7ed558ccd);
+        v ^= v >> 33;
+        *h ^= v;
+        *h *= Q_UINT64_C(0x100000001b3);
+    }
+    static void hashReal(quint64 *h, qreal v)
+    {
+        double d = v;
+        quint64 bits;
+        memcpy(&bits, &d, sizeof(bits));
+        hashWord(h, bits);
+    }
+
+    bool isEnabled() const { return maxBytes() > 0; }
+
+    // otherFill, when given, is the fill with the other fill rule. Entries
+    // inserted without one do not match then.
+    bool findFill(const Key &key, QQuickPathRenderer::FillGeometry *fill,
+                  QQuickPathRenderer::FillGeometry *otherFill = nullptr);
+    bool findStroke(const Key &key, QQuickPathRenderer::VertexContainer *strokeVertices,
+                    QQuickPathRenderer::FringeContainer *strokeFringe,
+                    QQuickPathRenderer::ExtrudedVertexContainer *extrudedStrokeVertices);
+    void insertFill(const Key &key, const QQuickPathRenderer::FillGeometry &fill,
+                    const QQuickPathRenderer::FillGeometry *otherFill = nullptr);
+    void insertStroke(const Key &key, const QQuickPathRenderer::VertexContainer &strokeVertices,
+                      const QQuickPathRenderer::FringeContainer &strokeFringe,
+                      const QQuickPathRenderer::ExtrudedVertexContainer &extrudedStrokeVertices);
+
+    // the budget is an estimate of the memory used by the cached data, 0 disables caching
+    int maxBytes() const;
+    void setMaxBytes(int bytes);
+    int totalBytes() const;
+
+    int hits() const;
+    int misses() const;
+    void resetCounters();
+
+    void clear();
+
+private:
+    struct Entry {
+        Entry() : hasOtherFill(false) { }
+        QQuickPathRenderer::FillGeometry fill;
+        QQuickPathRenderer::FillGeometry otherFill;
+        bool hasOtherFill;
+        QQuickPathRenderer::VertexContainer strokeVertices;
+        QQuickPathRenderer::FringeContainer strokeFringe;
+        QQuickPathRenderer::ExtrudedVertexContainer extrudedStrokeVertices;
+    };
+
+    void insert(const Key &key, Entry *e, int dataBytes);
+
+    mutable QMutex m_mutex;
+    QCache<Key, Entry> m_cache;
+    int m_hits;
+    int m_misses;
+};
+
+inline uint qHash(const QQuickPathTriangulationCache::Key &key, uint seed = 0)
+{
+    return uint(key.hash ^ (key.hash >> 32)) ^ seed;
+}
+
+QT_END_NAMESPACE
+
+#endif
@@ -13,7 +13,14 @@ SOURCES += $$PWD/qnvpr.cpp \
            $$PWD/qquickpathitem.cpp \
            $$PWD/qquickpathgradient.cpp \
            $$PWD/qquickpathcommand.cpp \
-           $$PWD/qquickpathgradientmaterial.cpp
+           $$PWD/qquickpathgradientmaterial.cpp \
+           $$PWD/qquickpathtriangulationcache.cpp \
+           $$PWD/qquickpathsmoothcolormaterial.cpp \
+           $$PWD/qquickpathsoftwarerenderer.cpp \
+           $$PWD/qquickpathstencilrenderer.cpp \
+           $$PWD/qquickpathcurvematerial.cpp \
+           $$PWD/qquickpathextrudedstrokematerial.cpp \
+           $$PWD/qquickpathsvgparser.cpp
 
 HEADERS += $$PWD/qnvpr.h \
            $$PWD/qnvpr_p.h \
@@ -26,6 +33,13 @@ HEADERS += $$PWD/qnvpr.h \
            $$PWD/qquickpathitem_p_p.h \
            $$PWD/qquickpathgradient_p.h \
            $$PWD/qquickpathcommand_p.h \
-           $$PWD/qquickpathgradientmaterial_p.h
+           $$PWD/qquickpathgradientmaterial_p.h \
+           $$PWD/qquickpathtriangulationcache_p.h \
+           $$PWD/qquickpathsmoothcolormaterial_p.h \
+           $$PWD/qquickpathsoftwarerenderer_p.h \
+           $$PWD/qquickpathstencilrenderer_p.h \
+           $$PWD/qquickpathcurvematerial_p.h \
+           $$PWD/qquickpathextrudedstrokematerial_p.h \
+           $$PWD/qquickpathsvgparser_p.h
 
 RESOURCES += $$PWD/quickpath.qrc
@@ -0,0 +1,19 @@
+#ifdef GL_ES
+#extension GL_OES_standard_derivatives : enable
+#endif
+
+varying lowp vec4 color;
+// (u, v, side): the curve is u^2 - v = 0 and the filled part is where
+// side * (u^2 - v) < 0. side is 0 for triangles without a curve.
+varying highp vec3 curve;
+
+void main()
+{
+    highp vec2 du = vec2(dFdx(curve.x), dFdy(curve.x));
+    highp vec2 dv = vec2(dFdx(curve.y), dFdy(curve.y));
+    highp vec2 grad = 2.0 * curve.x * du - dv;
+    // approximate signed distance in pixels, negative on the filled side
+    highp float dist = curve.z * (curve.x * curve.x - curve.y) / max(length(grad), 0.0001);
+    lowp float coverage = curve.z == 0.0 ? 1.0 : clamp(0.5 - dist, 0.0, 1.0);
+    gl_FragColor = color * coverage;
+}
@@ -0,0 +1,16 @@
+attribute highp vec4 vertexCoord;
+attribute lowp vec4 vertexColor;
+attribute highp vec3 vertexCurve;
+
+uniform highp mat4 matrix;
+uniform lowp float opacity;
+
+varying lowp vec4 color;
+varying highp vec3 curve;
+
+void main()
+{
+    gl_Position = matrix * vertexCoord;
+    color = vertexColor * opacity;
+    curve = vertexCurve;
+}
@@ -0,0 +1,87 @@
+#ifdef GL_ES
+#extension GL_OES_standard_derivatives : enable
+#endif
+
+varying lowp vec4 color;
+// 0 on the centerline, -1 or 1 on the edges
+varying highp float side;
+// distance along the subpath in item coordinates
+varying highp float pathLength;
+// fraction of the total path length
+varying highp float pathPosition;
+
+uniform highp float halfWidth;
+uniform lowp float antialiasing;
+
+// in stroke widths, dash and space lengths alternating, like QPen
+uniform highp float dashPattern[8];
+uniform int dashCount;
+uniform highp float dashPeriod; // 0 when not dashed
+uniform highp float dashOffset;
+
+// 0 flat, 1 square, 2 round, for each dash and the trimmed ends
+uniform lowp float capStyle;
+
+// the visible part of the path, as fractions of the total length
+uniform highp float trimStart;
+uniform highp float trimEnd;
+
+// signed distance to the dash [start, end], in stroke widths
+highp float dashDistance(highp float t, highp float start, highp float end)
+{
+    return max(start - t, t - end);
+}
+
+// d is the signed distance to the end of a dash or of the trimmed path, in
+// stroke widths along the path. Returns the distance to the cap's outline.
+highp float capDistance(highp float d)
+{
+    if (capStyle > 1.5)
+        return d > 0.0 ? length(vec2(d, 0.5 * side)) - 0.5 : d - 0.5;
+    if (capStyle > 0.5)
+        return d - 0.5;
+    return d;
+}
+
+void main()
+{
+    // distance to the edge in pixels, the geometry reaches half a pixel
+    // beyond it when antialiased
+    highp float dist = (1.0 - abs(side)) / max(fwidth(side), 0.0001);
+    lowp float coverage = mix(1.0, clamp(dist + 0.5, 0.0, 1.0), antialiasing);
+
+    if (dashPeriod > 0.0) {
+        highp float width = 2.0 * halfWidth;
+        highp float t = mod(pathLength / width + dashOffset, dashPeriod);
+        // the closest dash, including the ones in the previous and next period
+        highp float d = dashPeriod;
+        highp float start = 0.0;
+        for (int i = 0; i < 8; i += 2) {
+            if (i >= dashCount)
+                break;
+            highp float end = start + dashPattern[i];
+            d = min(d, dashDistance(t, start, end));
+            d = min(d, dashDistance(t - dashPeriod, start, end));
+            d = min(d, dashDistance(t + dashPeriod, start, end));
+            start = end + dashPattern[i + 1];
+        }
+        // each dash gets its own cap
+        d = capDistance(d);
+        // along the path in pixels
+        highp float dPixels = d * width / max(fwidth(pathLength), 0.0001);
+        coverage *= antialiasing > 0.5 ? clamp(0.5 - dPixels, 0.0, 1.0) : step(d, 0.0);
+    }
+
+    if (trimStart > 0.0 || trimEnd < 1.0) {
+        // The ends get the pen's cap, the same as when the trimmed path is
+        // stroked on the CPU. The distance is in pixels along the path,
+        // pathLength gives the scale between pixels and stroke widths.
+        highp float pixelsPerWidth = 2.0 * halfWidth / max(fwidth(pathLength), 0.0001);
+        highp float dt = max(trimStart - pathPosition, pathPosition - trimEnd)
+                / max(fwidth(pathPosition), 0.000001);
+        dt = capDistance(dt / pixelsPerWidth) * pixelsPerWidth;
+        coverage *= antialiasing > 0.5 ? clamp(0.5 - dt, 0.0, 1.0) : step(dt, 0.0);
+    }
+
+    gl_FragColor = color * coverage;
+}
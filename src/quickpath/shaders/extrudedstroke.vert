@@ -0,0 +1,40 @@
+attribute highp vec4 vertexCoord;
+attribute lowp vec4 vertexColor;
+// (dx, dy, side), the offset is for a half width of 1
+attribute highp vec3 vertexOffset;
+// (distance along the subpath, position along the whole path from 0 to 1)
+attribute highp vec2 vertexLength;
+
+uniform highp mat4 matrix;
+uniform lowp float opacity;
+uniform highp float halfWidth;
+uniform highp vec2 pixelSize;
+uniform lowp float antialiasing;
+
+varying lowp vec4 color;
+varying highp float side;
+varying highp float pathLength;
+varying highp float pathPosition;
+
+void main()
+{
+    highp vec4 pos = matrix * vec4(vertexCoord.xy + vertexOffset.xy * halfWidth, 0.0, 1.0);
+    side = vertexOffset.z;
+    if (antialiasing > 0.5 && vertexOffset.z != 0.0) {
+        // Push the edge out by half a pixel so that the coverage ramp is
+        // centered on the true edge, where side stays 1. dir is how far the
+        // vertex moves on screen, in pixels, per unit of offset.
+        highp vec4 delta = matrix * vec4(vertexOffset.xy, 0.0, 0.0);
+        highp vec2 dir = (delta.xy * pos.w - pos.xy * delta.w) / (pos.w * pos.w * pixelSize);
+        highp float len = length(dir);
+        if (len > 0.0) {
+            highp float grow = 0.5 / len;
+            pos += delta * grow;
+            side *= 1.0 + grow / max(halfWidth, 0.0001);
+        }
+    }
+    gl_Position = pos;
+    color = vertexColor * opacity;
+    pathLength = vertexLength.x;
+    pathPosition = vertexLength.y;
+}
@@ -2,8 +2,11 @@ uniform sampler2D gradTabTexture;
 uniform highp float opacity;
 
 varying highp float gradTabIndex;
+varying highp float gradTabRow;
+varying highp float gradRepeat;
 
 void main()
 {
-    gl_FragColor = texture2D(gradTabTexture, vec2(gradTabIndex, 0.5)) * opacity;
+    highp float t = mix(clamp(gradTabIndex, 0.0, 1.0), fract(gradTabIndex), gradRepeat);
+    gl_FragColor = texture2D(gradTabTexture, vec2(t, gradTabRow)) * opacity;
 }
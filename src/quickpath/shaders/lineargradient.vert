@@ -1,21 +1,18 @@
 attribute vec4 vertexCoord;
-attribute vec4 vertexColor;
+attribute vec3 vertexGradient;
 
 uniform mat4 matrix;
-uniform vec2 viewportSize;
-uniform vec2 gradStart;
-uniform vec2 gradEnd;
+uniform float textureRows;
 
 varying float gradTabIndex;
+varying float gradTabRow;
+varying float gradRepeat;
 
 void main()
 {
-    vec4 pos = matrix * vertexCoord;
-    vec2 v = pos.xy / pos.w;
-    v.x = 1.0 + v.x * 0.5 * viewportSize.x;
-    v.y = 1.0 + v.y * 0.5 * viewportSize.y;
-    vec2 gradVec = gradEnd - gradStart;
-    // project v onto gradVec to get a color table index
-    gradTabIndex = dot(gradVec, v) / (gradVec.x * gradVec.x + gradVec.y * gradVec.y);
-    gl_Position = pos;
+    // position along the gradient, the color table's row and the spread
+    gradTabIndex = vertexGradient.x;
+    gradTabRow = (vertexGradient.y + 0.5) / textureRows;
+    gradRepeat = vertexGradient.z;
+    gl_Position = matrix * vertexCoord;
 }
@@ -0,0 +1,26 @@
+attribute highp vec4 vertexCoord;
+attribute lowp vec4 vertexColor;
+attribute highp vec2 vertexOffset;
+
+uniform highp mat4 matrix;
+uniform highp vec2 pixelSize;
+uniform lowp float opacity;
+
+varying lowp vec4 color;
+
+void main()
+{
+    highp vec4 pos = matrix * vertexCoord;
+    if (vertexOffset.x != 0.0 || vertexOffset.y != 0.0) {
+        // Direction of the offset on screen, measured in pixels. The vertex
+        // is moved along it by the length of the offset, so the fringe stays
+        // the same width regardless of the item's scale.
+        highp vec4 delta = matrix * vec4(vertexOffset, 0.0, 0.0);
+        highp vec2 dir = (delta.xy * pos.w - pos.xy * delta.w) / pixelSize;
+        highp float len = length(dir);
+        if (len > 0.0)
+            pos.xy += dir / len * length(vertexOffset) * pixelSize * pos.w;
+    }
+    gl_Position = pos;
+    color = vertexColor * opacity;
+}
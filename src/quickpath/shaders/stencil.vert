@@ -0,0 +1,16 @@
+attribute highp vec4 vertexCoord;
+
+uniform highp mat4 matrix;
+uniform highp vec2 gradStart;
+uniform highp vec2 gradEnd;
+
+varying highp float gradTabIndex;
+
+void main()
+{
+    // only used when covering with a gradient
+    highp vec2 gradVec = gradEnd - gradStart;
+    highp float len2 = dot(gradVec, gradVec);
+    gradTabIndex = len2 > 0.0 ? dot(gradVec, vertexCoord.xy - gradStart) / len2 : 0.0;
+    gl_Position = matrix * vertexCoord;
+}
@@ -0,0 +1,12 @@
+uniform sampler2D gradTabTexture;
+uniform highp float opacity;
+uniform highp float gradTabRow;
+uniform highp float gradRepeat;
+
+varying highp float gradTabIndex;
+
+void main()
+{
+    highp float t = mix(clamp(gradTabIndex, 0.0, 1.0), fract(gradTabIndex), gradRepeat);
+    gl_FragColor = texture2D(gradTabTexture, vec2(t, gradTabRow)) * opacity;
+}
@@ -0,0 +1,5 @@
+CONFIG += testcase
+TARGET = tst_pathcommands
+QT = core gui testlib qml quick quickpath-private
+
+SOURCES += tst_pathcommands.cpp
@@ -0,0 +1,279 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the QtQuickPath module
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtQuickPath/private/qquickpathitem_p.h>
+#include <QtQuickPath/private/qquickpathitem_p_p.h>
+#include <QtQuickPath/private/qquickpathcommand_p.h>
+
+// Changes the commands of a PathItem and checks that the path patched in
+// place by updatePathFromCommands(), or rebuilt when that is not possible,
+// is the same as one built from scratch.
+
+class tst_PathCommands : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void coordinates_data();
+    void coordinates();
+    void structure_data();
+    void structure();
+    void severalCommands();
+    void appendCommand();
+    void pathData();
+
+private:
+    template <typename T> T *command(int index) const
+    {
+        return qobject_cast<T *>(QQuickPathItemPrivate::get(m_item)->commands.at(index));
+    }
+    void append(QQuickPathCommand *cmd);
+    bool sync();
+    QPainterPath freshPath() const;
+
+    QQuickPathItem *m_item;
+};
+
+void tst_PathCommands::init()
+{
+    m_item = new QQuickPathItem;
+
+    // the setters notify the parent item, also before the command is added
+
+    QQuickPathMoveTo *moveTo = new QQuickPathMoveTo(m_item);
+    moveTo->setX(10);
+    moveTo->setY(10);
+    append(moveTo);
+    QQuickPathLineTo *lineTo = new QQuickPathLineTo(m_item);
+    lineTo->setX(50);
+    lineTo->setY(10);
+    append(lineTo);
+    QQuickPathQuadTo *quadTo = new QQuickPathQuadTo(m_item);
+    quadTo->setCx(60);
+    quadTo->setCy(30);
+    quadTo->setEx(50);
+    quadTo->setEy(50);
+    append(quadTo);
+    QQuickPathCubicTo *cubicTo = new QQuickPathCubicTo(m_item);
+    cubicTo->setCx1(40);
+    cubicTo->setCy1(60);
+    cubicTo->setCx2(20);
+    cubicTo->setCy2(60);
+    cubicTo->setEx(10);
+    cubicTo->setEy(50);
+    append(cubicTo);
+    QQuickPathArcTo *arcTo = new QQuickPathArcTo(m_item);
+    arcTo->setX(0);
+    arcTo->setY(20);
+    arcTo->setWidth(20);
+    arcTo->setHeight(20);
+    arcTo->setStartAngle(270);
+    arcTo->setArcLength(-90);
+    append(arcTo);
+    append(new QQuickPathClose);
+    moveTo = new QQuickPathMoveTo(m_item);
+    moveTo->setX(100);
+    moveTo->setY(100);
+    append(moveTo);
+    lineTo = new QQuickPathLineTo(m_item);
+    lineTo->setX(150);
+    lineTo->setY(100);
+    append(lineTo);
+    QQuickPathSvg *svg = new QQuickPathSvg(m_item);
+    svg->setPath(QStringLiteral("l 0 50 h -50"));
+    append(svg);
+    lineTo = new QQuickPathLineTo(m_item);
+    lineTo->setX(120);
+    lineTo->setY(180);
+    append(lineTo);
+
+    QVERIFY(!sync());
+    QCOMPARE(QQuickPathItemPrivate::get(m_item)->path, freshPath());
+}
+
+void tst_PathCommands::cleanup()
+{
+    delete m_item;
+}
+
+// goes through the QML list property, like the commands declared in QML
+void tst_PathCommands::append(QQuickPathCommand *cmd)
+{
+    QQmlListProperty<QObject> commands = m_item->commands();
+    commands.append(&commands, cmd);
+}
+
+// Brings the path up to date the way QQuickPathItemPrivate::sync() does.
+// Returns true when it got patched in place.
+bool tst_PathCommands::sync()
+{
+    QQuickPathItemPrivate *d = QQuickPathItemPrivate::get(m_item);
+    int firstElement = -1;
+    int lastElement = -1;
+    const bool updated = d->updatePathFromCommands(&firstElement, &lastElement);
+    if (!updated)
+        d->buildPathFromCommands();
+    d->firstDirtyCommand = -1;
+    d->lastDirtyCommand = -1;
+    return updated;
+}
+
+QPainterPath tst_PathCommands::freshPath() const
+{
+    QQuickPathItemPrivate *d = QQuickPathItemPrivate::get(m_item);
+    QPainterPath path;
+    path.setFillRule(d->path.fillRule());
+    for (QQuickPathCommand *cmd : qAsConst(d->commands))
+        cmd->addToPath(&path);
+    return path;
+}
+
+static void addPropertyRows()
+{
+    QTest::addColumn<int>("index");
+    QTest::addColumn<QByteArray>("property");
+    QTest::addColumn<QVariant>("value");
+}
+
+void tst_PathCommands::coordinates_data()
+{
+    addPropertyRows();
+
+    QTest::newRow("first moveTo") << 0 << QByteArray("x") << QVariant(15.0);
+    QTest::newRow("lineTo") << 1 << QByteArray("y") << QVariant(5.0);
+    QTest::newRow("quadTo control point") << 2 << QByteArray("cx") << QVariant(70.0);
+    QTest::newRow("quadTo end point") << 2 << QByteArray("ey") << QVariant(55.0);
+    QTest::newRow("cubicTo end point") << 3 << QByteArray("ex") << QVariant(5.0);
+    QTest::newRow("arcTo rectangle") << 4 << QByteArray("x") << QVariant(-5.0);
+    QTest::newRow("arcTo height") << 4 << QByteArray("height") << QVariant(30.0);
+    QTest::newRow("moveTo after close") << 6 << QByteArray("y") << QVariant(90.0);
+    QTest::newRow("PathSvg coordinates") << 8 << QByteArray("path") << QVariant(QStringLiteral("l 0 60 h -40"));
+    QTest::newRow("last lineTo") << 9 << QByteArray("x") << QVariant(130.0);
+}
+
+// the element types stay the same, the path gets patched in place
+void tst_PathCommands::coordinates()
+{
+    QFETCH(int, index);
+    QFETCH(QByteArray, property);
+    QFETCH(QVariant, value);
+
+    QVERIFY(command<QQuickPathCommand>(index)->setProperty(property, value));
+    QVERIFY(sync());
+    QCOMPARE(QQuickPathItemPrivate::get(m_item)->path, freshPath());
+
+    // and again, from the patched path
+    QVERIFY(command<QQuickPathMoveTo>(0)->setProperty("y", 12.0));
+    QVERIFY(sync());
+    QCOMPARE(QQuickPathItemPrivate::get(m_item)->path, freshPath());
+}
+
+void tst_PathCommands::structure_data()
+{
+    addPropertyRows();
+
+    QTest::newRow("arcTo gets longer") << 4 << QByteArray("arcLength") << QVariant(-270.0);
+    QTest::newRow("PathSvg with other commands") << 8 << QByteArray("path") << QVariant(QStringLiteral("l 0 50 q 10 10 20 0"));
+    QTest::newRow("PathSvg with a new subpath") << 8 << QByteArray("path") << QVariant(QStringLiteral("l 0 50 m 10 10 h 5"));
+}
+
+// the elements change, the path gets rebuilt
+void tst_PathCommands::structure()
+{
+    QFETCH(int, index);
+    QFETCH(QByteArray, property);
+    QFETCH(QVariant, value);
+
+    QVERIFY(command<QQuickPathCommand>(index)->setProperty(property, value));
+    QVERIFY(!sync());
+    QCOMPARE(QQuickPathItemPrivate::get(m_item)->path, freshPath());
+
+    // the rebuilt path can be patched again
+    QVERIFY(command<QQuickPathLineTo>(9)->setProperty("y", 170.0));
+    QVERIFY(sync());
+    QCOMPARE(QQuickPathItemPrivate::get(m_item)->path, freshPath());
+}
+
+// the commands between the dirty ones are run again as well
+void tst_PathCommands::severalCommands()
+{
+    command<QQuickPathLineTo>(1)->setX(55);
+    command<QQuickPathMoveTo>(6)->setX(105);
+    command<QQuickPathLineTo>(9)->setY(185);
+    QVERIFY(sync());
+    QCOMPARE(QQuickPathItemPrivate::get(m_item)->path, freshPath());
+}
+
+void tst_PathCommands::appendCommand()
+{
+    QQuickPathLineTo *lineTo = new QQuickPathLineTo(m_item);
+    lineTo->setX(100);
+    lineTo->setY(200);
+    append(lineTo);
+    lineTo->setY(210);
+    QVERIFY(!sync());
+    QCOMPARE(QQuickPathItemPrivate::get(m_item)->path, freshPath());
+}
+
+// A path set from pathData replaces the one built from the commands until a
+// command changes. It has the same number of elements here, so it could pass
+// for the commands' path.
+void tst_PathCommands::pathData()
+{
+    QQuickPathItemPrivate *d = QQuickPathItemPrivate::get(m_item);
+    QString data = QStringLiteral("M 0 0");
+    for (int i = 1; i < d->path.elementCount(); ++i)
+        data += QStringLiteral(" L %1 %2").arg(i).arg(i * i);
+    m_item->setPathData(data);
+    QCOMPARE(d->path.elementCount(), freshPath().elementCount());
+    QCOMPARE(m_item->pathData(), data);
+
+    command<QQuickPathLineTo>(1)->setX(55);
+    QVERIFY(!sync());
+    QCOMPARE(d->path, freshPath());
+
+    command<QQuickPathLineTo>(1)->setX(60);
+    QVERIFY(sync());
+    QCOMPARE(d->path, freshPath());
+}
+
+QTEST_MAIN(tst_PathCommands)
+
+#include "tst_pathcommands.moc"
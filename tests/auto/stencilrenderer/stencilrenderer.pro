@@ -0,0 +1,5 @@
+CONFIG += testcase
+TARGET = tst_stencilrenderer
+QT = core gui testlib quick quickpath-private
+
+SOURCES += tst_stencilrenderer.cpp
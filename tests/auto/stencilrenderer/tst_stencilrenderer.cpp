@@ -0,0 +1,172 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the QtQuickPath module
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtQuick/QQuickWindow>
+#include <QtQuickPath/private/qquickpathitem_p.h>
+#include <QtQuickPath/private/qquickpathitem_p_p.h>
+#include <QtQuickPath/private/qquickpathstencilrenderer_p.h>
+
+// Renders into a window with the stencil-then-cover backend and checks the
+// pixels where fill rules and overlapping strokes make a difference. Runs
+// fine on software OpenGL, e.g. llvmpipe.
+
+class tst_StencilRenderer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void fillRule_data();
+    void fillRule();
+    void selfIntersectingStroke();
+
+private:
+    QImage render(QQuickPathItem *item);
+};
+
+static const QColor background(Qt::white);
+
+void tst_StencilRenderer::initTestCase()
+{
+    // read once, before the first PathItem gets a renderer
+    qputenv("QT_QUICKPATH_STENCIL_THEN_COVER", "1");
+}
+
+// Shows item in a 200x200 window and grabs it. The image is null when the
+// scene graph does not run on OpenGL.
+QImage tst_StencilRenderer::render(QQuickPathItem *item)
+{
+    QQuickWindow window;
+    window.setColor(background);
+    window.resize(200, 200);
+    item->setParentItem(window.contentItem());
+    item->setSize(QSizeF(200, 200));
+    window.show();
+
+    QImage image;
+    if (QTest::qWaitForWindowExposed(&window)
+            && window.rendererInterface()->graphicsApi() == QSGRendererInterface::OpenGL) {
+        image = window.grabWindow().convertToFormat(QImage::Format_RGB32);
+        if (!dynamic_cast<QQuickPathStencilRenderer *>(QQuickPathItemPrivate::get(item)->renderer))
+            image = QImage();
+    }
+
+    item->setParentItem(nullptr);
+    return image;
+}
+
+static bool fuzzyCompare(QRgb a, QRgb b)
+{
+    const int tolerance = 3;
+    return qAbs(qRed(a) - qRed(b)) <= tolerance
+        && qAbs(qGreen(a) - qGreen(b)) <= tolerance
+        && qAbs(qBlue(a) - qBlue(b)) <= tolerance;
+}
+
+void tst_StencilRenderer::fillRule_data()
+{
+    QTest::addColumn<QQuickPathItem::FillRule>("fillRule");
+    QTest::addColumn<bool>("centerFilled");
+
+    QTest::newRow("odd-even") << QQuickPathItem::OddEvenFill << false;
+    QTest::newRow("winding") << QQuickPathItem::WindingFill << true;
+}
+
+// A pentagram: the pentagon in the middle has a winding number of 2, the
+// points of the star have 1.
+void tst_StencilRenderer::fillRule()
+{
+    QFETCH(QQuickPathItem::FillRule, fillRule);
+    QFETCH(bool, centerFilled);
+
+    QQuickPathItem item;
+    item.setFillColor(Qt::red);
+    item.setStrokeColor(Qt::transparent);
+    item.setFillRule(fillRule);
+    for (int i = 0; i < 5; ++i) {
+        const qreal angle = 2 * M_PI * ((i * 2) % 5) / 5 - M_PI / 2;
+        const qreal x = 100 + 90 * qCos(angle);
+        const qreal y = 100 + 90 * qSin(angle);
+        if (i == 0)
+            item.moveTo(x, y);
+        else
+            item.lineTo(x, y);
+    }
+    item.closeSubPath();
+
+    const QImage image = render(&item);
+    if (image.isNull())
+        QSKIP("The stencil renderer needs an OpenGL scene graph");
+
+    const QRgb fill = QColor(Qt::red).rgb();
+    QVERIFY(fuzzyCompare(image.pixel(100, 20), fill));
+    QVERIFY(fuzzyCompare(image.pixel(5, 5), background.rgb()));
+    QCOMPARE(fuzzyCompare(image.pixel(100, 100), fill), centerFilled);
+    QCOMPARE(fuzzyCompare(image.pixel(100, 100), background.rgb()), !centerFilled);
+}
+
+// The triangles of a stroke overlap at joins and wherever the path crosses
+// itself. A translucent stroke must still be blended exactly once.
+void tst_StencilRenderer::selfIntersectingStroke()
+{
+    QQuickPathItem item;
+    item.setFillColor(Qt::transparent);
+    item.setStrokeColor(QColor(0, 0, 255, 128));
+    item.setStrokeWidth(10);
+    item.setJoinStyle(QQuickPathItem::MiterJoin);
+    item.moveTo(20, 20);
+    item.lineTo(180, 180);
+    item.lineTo(180, 20);
+    item.lineTo(20, 180);
+    item.closeSubPath();
+
+    const QImage image = render(&item);
+    if (image.isNull())
+        QSKIP("The stencil renderer needs an OpenGL scene graph");
+
+    const QRgb single = image.pixel(60, 60);
+    QVERIFY(!fuzzyCompare(single, background.rgb()));
+    QVERIFY(fuzzyCompare(image.pixel(100, 100), single));    // crossing
+    QVERIFY(fuzzyCompare(image.pixel(180, 180), single));    // join
+    QVERIFY(fuzzyCompare(image.pixel(20, 100), single));     // closing segment
+    QVERIFY(fuzzyCompare(image.pixel(100, 60), background.rgb()));
+}
+
+QTEST_MAIN(tst_StencilRenderer)
+
+#include "tst_stencilrenderer.moc"
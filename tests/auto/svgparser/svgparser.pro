@@ -0,0 +1,5 @@
+CONFIG += testcase
+TARGET = tst_svgparser
+QT = core gui testlib quickpath-private
+
+SOURCES += tst_svgparser.cpp
@@ -0,0 +1,319 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the QtQuickPath module
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtQuickPath/private/qquickpathsvgparser_p.h>
+
+Q_DECLARE_METATYPE(QPainterPath)
+
+class tst_SvgParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void grammar_data();
+    void grammar();
+    void arcFlags_data();
+    void arcFlags();
+    void arc_data();
+    void arc();
+    void continuePath();
+};
+
+static QString describe(const QPainterPath &path)
+{
+    static const char types[] = { 'M', 'L', 'C', 'c' };
+    QString result;
+    for (int i = 0; i < path.elementCount(); ++i) {
+        const QPainterPath::Element &e = path.elementAt(i);
+        result += QString::fromLatin1("%1%2,%3 ").arg(QLatin1Char(types[e.type])).arg(e.x).arg(e.y);
+    }
+    return result;
+}
+
+static bool fuzzyEqual(const QPainterPath &a, const QPainterPath &b)
+{
+    if (a.elementCount() != b.elementCount())
+        return false;
+    for (int i = 0; i < a.elementCount(); ++i) {
+        const QPainterPath::Element &ea = a.elementAt(i);
+        const QPainterPath::Element &eb = b.elementAt(i);
+        if (ea.type != eb.type || qAbs(ea.x - eb.x) > 1e-9 || qAbs(ea.y - eb.y) > 1e-9)
+            return false;
+    }
+    return true;
+}
+
+#define COMPARE_PATHS(actual, expected) \
+    QVERIFY2(fuzzyEqual(actual, expected), \
+             qPrintable(QString::fromLatin1("\n   Actual: %1\n Expected: %2").arg(describe(actual), describe(expected))))
+
+void tst_SvgParser::grammar_data()
+{
+    QTest::addColumn<QString>("data");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<QPainterPath>("expected");
+
+    QPainterPath p;
+    QTest::newRow("empty") << QString() << true << p;
+    QTest::newRow("whitespace") << QStringLiteral(" \t\r\n ") << true << p;
+
+    p = QPainterPath();
+    p.moveTo(10, 20);
+    p.lineTo(30, 40);
+    QTest::newRow("absolute") << QStringLiteral("M 10 20 L 30 40") << true << p;
+    QTest::newRow("commas") << QStringLiteral("M10,20 L30 , 40") << true << p;
+    QTest::newRow("separators") << QStringLiteral("  M10,20 L 30,40  ") << true << p;
+    QTest::newRow("no separators") << QStringLiteral("M10 20L30 40") << true << p;
+    QTest::newRow("relative") << QStringLiteral("m 10 20 l 20 20") << true << p;
+
+    p = QPainterPath();
+    p.moveTo(0.5, 0.5);
+    p.lineTo(10, -0.15);
+    p.lineTo(-0.25, 1e-3);
+    QTest::newRow("packed numbers") << QStringLiteral("M.5.5L1e1-1.5e-1-.25+1E-3") << true << p;
+
+    p = QPainterPath();
+    p.moveTo(5, 5);
+    p.lineTo(15, 5);
+    p.lineTo(15, 15);
+    p.lineTo(5, 15);
+    QTest::newRow("h and v") << QStringLiteral("M5 5h10v10H5") << true << p;
+    QTest::newRow("implicit lineto") << QStringLiteral("M5 5 15 5 15 15 5 15") << true << p;
+    QTest::newRow("implicit relative lineto") << QStringLiteral("m5 5 10 0 0 10 -10 0") << true << p;
+    QTest::newRow("repeated lineto") << QStringLiteral("M5 5 L15 5 15 15 5 15") << true << p;
+
+    p = QPainterPath();
+    p.moveTo(5, 5);
+    p.lineTo(10, 5);
+    p.lineTo(15, 5);
+    p.lineTo(15, 10);
+    p.lineTo(15, 15);
+    p.lineTo(10, 15);
+    p.lineTo(5, 15);
+    QTest::newRow("repeated h and v") << QStringLiteral("M5 5 h5 5 v5 5 H10 5") << true << p;
+
+    p = QPainterPath();
+    p.moveTo(0, 0);
+    p.cubicTo(10, 0, 20, 10, 20, 20);
+    p.cubicTo(20, 30, 30, 40, 40, 40);
+    QTest::newRow("smooth cubic") << QStringLiteral("M0 0C10 0 20 10 20 20S30 40 40 40") << true << p;
+    QTest::newRow("relative smooth cubic") << QStringLiteral("m0 0c10 0 20 10 20 20s10 20 20 20") << true << p;
+    QTest::newRow("implicit cubic") << QStringLiteral("M0 0C10 0 20 10 20 20 20 30 30 40 40 40") << true << p;
+
+    p = QPainterPath();
+    p.moveTo(0, 0);
+    p.lineTo(10, 0);
+    p.cubicTo(10, 0, 20, 10, 30, 0);
+    QTest::newRow("smooth cubic after a line") << QStringLiteral("M0 0H10S20 10 30 0") << true << p;
+
+    p = QPainterPath();
+    p.moveTo(0, 0);
+    p.quadTo(10, 10, 20, 0);
+    p.quadTo(30, -10, 40, 0);
+    p.quadTo(50, 10, 60, 0);
+    QTest::newRow("smooth quad") << QStringLiteral("M0 0Q10 10 20 0T40 0 60 0") << true << p;
+    QTest::newRow("relative smooth quad") << QStringLiteral("M0 0q10 10 20 0t20 0t20 0") << true << p;
+
+    p = QPainterPath();
+    p.moveTo(10, 10);
+    p.lineTo(20, 10);
+    p.lineTo(20, 20);
+    p.closeSubpath();
+    p.lineTo(10, 30);
+    QTest::newRow("relative after close") << QStringLiteral("M10 10h10v10zl0 20") << true << p;
+
+    p = QPainterPath();
+    p.moveTo(10, 10);
+    p.lineTo(20, 10);
+    p.closeSubpath();
+    p.moveTo(15, 15);
+    p.lineTo(25, 15);
+    QTest::newRow("moveto after close") << QStringLiteral("M10 10h10zm5 5h10") << true << p;
+
+    p = QPainterPath();
+    p.moveTo(0, 0);
+    p.lineTo(10, 10);
+    QTest::newRow("unknown command") << QStringLiteral("M0 0L10 10X5 5") << false << p;
+    QTest::newRow("missing coordinate") << QStringLiteral("M0 0L10 10L5") << false << p;
+    p.closeSubpath();
+    QTest::newRow("coordinates after close") << QStringLiteral("M0 0L10 10z5 5") << false << p;
+    QTest::newRow("number first") << QStringLiteral("10 10") << false << QPainterPath();
+    QTest::newRow("lineto first") << QStringLiteral("L10 10") << false << QPainterPath();
+}
+
+void tst_SvgParser::grammar()
+{
+    QFETCH(QString, data);
+    QFETCH(bool, valid);
+    QFETCH(QPainterPath, expected);
+
+    QPainterPath path;
+    QCOMPARE(QQuickPathSvgParser::parse(data, &path), valid);
+    COMPARE_PATHS(path, expected);
+}
+
+void tst_SvgParser::arcFlags_data()
+{
+    QTest::addColumn<QString>("data");
+    QTest::addColumn<QString>("spaced");
+
+    QTest::newRow("packed flags") << QStringLiteral("M0 0a1 1 0 00 1 1") << QStringLiteral("M0 0 a 1 1 0 0 0 1 1");
+    QTest::newRow("flags and coordinate") << QStringLiteral("M0 0a1 1 0 111 1") << QStringLiteral("M0 0 a 1 1 0 1 1 1 1");
+    QTest::newRow("flags with commas") << QStringLiteral("M0 0a1,1,0,0,1,1,1") << QStringLiteral("M0 0 a 1 1 0 0 1 1 1");
+    QTest::newRow("implicit arc") << QStringLiteral("M0 0a1 1 0 011 1 1 1 0 01-1 1")
+                                  << QStringLiteral("M0 0 a 1 1 0 0 1 1 1 a 1 1 0 0 1 -1 1");
+}
+
+// arc flags are single digits and may be written without separators
+void tst_SvgParser::arcFlags()
+{
+    QFETCH(QString, data);
+    QFETCH(QString, spaced);
+
+    QPainterPath path;
+    QVERIFY(QQuickPathSvgParser::parse(data, &path));
+    QPainterPath expected;
+    QVERIFY(QQuickPathSvgParser::parse(spaced, &expected));
+    QVERIFY(expected.elementCount() > 1);
+    COMPARE_PATHS(path, expected);
+}
+
+void tst_SvgParser::arc_data()
+{
+    QTest::addColumn<QString>("data");
+    QTest::addColumn<QPointF>("center");
+    QTest::addColumn<qreal>("rx");
+    QTest::addColumn<qreal>("ry");
+    QTest::addColumn<qreal>("angle");
+    // a point the arc goes through, other than its ends
+    QTest::addColumn<QPointF>("through");
+
+    // the two half circles between (0, 0) and (20, 0)
+    QTest::newRow("sweep") << QStringLiteral("M0 0A10 10 0 0 1 20 0")
+                           << QPointF(10, 0) << qreal(10) << qreal(10) << qreal(0) << QPointF(10, -10);
+    QTest::newRow("no sweep") << QStringLiteral("M0 0A10 10 0 0 0 20 0")
+                              << QPointF(10, 0) << qreal(10) << qreal(10) << qreal(0) << QPointF(10, 10);
+    // radii that are too small get scaled up
+    QTest::newRow("small radii") << QStringLiteral("M0 0A1 1 0 0 1 20 0")
+                                 << QPointF(10, 0) << qreal(10) << qreal(10) << qreal(0) << QPointF(10, -10);
+
+    // quarter circles between (0, 0) and (10, 10), the flags pick one of
+    // the two possible centers and one of the two arcs around it
+    QTest::newRow("small arc, sweep") << QStringLiteral("M0 0A10 10 0 0 1 10 10")
+                                      << QPointF(0, 10) << qreal(10) << qreal(10) << qreal(0)
+                                      << QPointF(10 * M_SQRT1_2, 10 - 10 * M_SQRT1_2);
+    QTest::newRow("large arc, sweep") << QStringLiteral("M0 0A10 10 0 1 1 10 10")
+                                      << QPointF(10, 0) << qreal(10) << qreal(10) << qreal(0) << QPointF(20, 0);
+    QTest::newRow("small arc, no sweep") << QStringLiteral("M0 0A10 10 0 0 0 10 10")
+                                         << QPointF(10, 0) << qreal(10) << qreal(10) << qreal(0)
+                                         << QPointF(10 - 10 * M_SQRT1_2, 10 * M_SQRT1_2);
+    QTest::newRow("large arc, no sweep") << QStringLiteral("M0 0A10 10 0 1 0 10 10")
+                                         << QPointF(0, 10) << qreal(10) << qreal(10) << qreal(0) << QPointF(-10, 10);
+
+    // an ellipse turned by 90 degrees, its long axis is vertical
+    QTest::newRow("rotated") << QStringLiteral("M0 0A20 10 90 0 1 0 40")
+                             << QPointF(0, 20) << qreal(20) << qreal(10) << qreal(90) << QPointF(10, 20);
+    QTest::newRow("relative") << QStringLiteral("M5 5a10 10 0 0 1 20 0")
+                              << QPointF(15, 5) << qreal(10) << qreal(10) << qreal(0) << QPointF(15, -5);
+}
+
+// The endpoint parameterization is converted to a center, checked by the
+// cubics' end points and midpoints being on the ellipse. Both are exact for
+// cubics approximating an arc of at most a quarter turn.
+void tst_SvgParser::arc()
+{
+    QFETCH(QString, data);
+    QFETCH(QPointF, center);
+    QFETCH(qreal, rx);
+    QFETCH(qreal, ry);
+    QFETCH(qreal, angle);
+    QFETCH(QPointF, through);
+
+    QPainterPath path;
+    QVERIFY(QQuickPathSvgParser::parse(data, &path));
+    QVERIFY(path.elementCount() >= 4);
+
+    const qreal phi = qDegreesToRadians(angle);
+    // 1 on the ellipse
+    const auto ellipse = [&](const QPointF &pt) {
+        const QPointF d = pt - center;
+        const qreal x = d.x() * qCos(phi) + d.y() * qSin(phi);
+        const qreal y = -d.x() * qSin(phi) + d.y() * qCos(phi);
+        return (x * x) / (rx * rx) + (y * y) / (ry * ry);
+    };
+
+    const auto isThrough = [&](const QPointF &pt) {
+        const QPointF d = pt - through;
+        return d.x() * d.x() + d.y() * d.y() < 1e-12;
+    };
+
+    bool passed = false;
+    for (int i = 1; i < path.elementCount(); i += 3) {
+        QCOMPARE(path.elementAt(i).type, QPainterPath::CurveToElement);
+        const QPointF p0 = path.elementAt(i - 1);
+        const QPointF p1 = path.elementAt(i);
+        const QPointF p2 = path.elementAt(i + 1);
+        const QPointF p3 = path.elementAt(i + 2);
+        const QPointF mid = (p0 + 3 * p1 + 3 * p2 + p3) / 8;
+        QVERIFY(qAbs(ellipse(p3) - 1) < 1e-9);
+        QVERIFY(qAbs(ellipse(mid) - 1) < 1e-9);
+        passed = passed || isThrough(mid) || isThrough(p3);
+    }
+    QVERIFY(passed);
+}
+
+// PathSvg fragments continue the path the previous commands built, z goes
+// back to the start of that subpath.
+void tst_SvgParser::continuePath()
+{
+    QPainterPath path;
+    path.moveTo(10, 10);
+    path.lineTo(20, 10);
+    QVERIFY(QQuickPathSvgParser::parse(QStringLiteral("l0 10zl5 0"), &path));
+
+    QPainterPath expected;
+    expected.moveTo(10, 10);
+    expected.lineTo(20, 10);
+    expected.lineTo(20, 20);
+    expected.closeSubpath();
+    expected.lineTo(15, 10);
+    COMPARE_PATHS(path, expected);
+}
+
+QTEST_MAIN(tst_SvgParser)
+
+#include "tst_svgparser.moc"
@@ -0,0 +1,8 @@
+CONFIG += benchmark
+TEMPLATE = app
+TARGET = tst_bench_gradient
+QT = core gui gui-private testlib quick quickpath-private
+
+SOURCES += tst_bench_gradient.cpp
+
+include(../shared/shared.pri)
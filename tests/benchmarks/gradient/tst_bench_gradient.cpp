@@ -0,0 +1,219 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the QtQuickPath module
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QOpenGLContext>
+#include <QOffscreenSurface>
+#include <QtQuickPath/private/qquickpathgradientmaterial_p.h>
+
+#include "benchmarkcounter.h"
+
+class tst_Bench_Gradient : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void colorTable_data();
+    void colorTable();
+    void cacheHit();
+    void cacheMiss();
+    void animatedStops();
+
+private:
+    static QQuickPathRenderer::GradientDesc gradient(int stopCount, int variant);
+    static QQuickPathRenderer::GradientTable table(const QQuickPathRenderer::GradientDesc &grad);
+
+    QOpenGLContext *m_context;
+    QOffscreenSurface *m_surface;
+};
+
+// Gradients with a different variant have different stop colors, the color
+// tables are only shared between equal stops.
+QQuickPathRenderer::GradientDesc tst_Bench_Gradient::gradient(int stopCount, int variant)
+{
+    QQuickPathRenderer::GradientDesc grad;
+    grad.start = QPointF(0, 0);
+    grad.end = QPointF(100, 100);
+    grad.spread = QQuickPathGradient::PadSpread;
+    for (int i = 0; i < stopCount; ++i) {
+        const qreal t = stopCount > 1 ? qreal(i) / (stopCount - 1) : 0;
+        QColor c = QColor::fromHsvF(t, 1, 1, 0.5 + t / 2);
+        c.setRed((c.red() + variant) & 0xFF);
+        c.setBlue((c.blue() + variant / 256) & 0xFF);
+        grad.stops.append(QGradientStop(t, c));
+    }
+    return grad;
+}
+
+// the table the renderer would generate during the sync
+QQuickPathRenderer::GradientTable tst_Bench_Gradient::table(const QQuickPathRenderer::GradientDesc &grad)
+{
+    QQuickPathRenderer::GradientTable t;
+    QQuickPathRenderer::updateGradientTable(&t, grad.stops);
+    return t;
+}
+
+void tst_Bench_Gradient::initTestCase()
+{
+    m_context = nullptr;
+    m_surface = new QOffscreenSurface;
+    m_surface->create();
+
+    QScopedPointer<QOpenGLContext> context(new QOpenGLContext);
+    if (context->create() && context->makeCurrent(m_surface))
+        m_context = context.take();
+}
+
+void tst_Bench_Gradient::cleanupTestCase()
+{
+    if (m_context)
+        m_context->doneCurrent();
+    delete m_context;
+    delete m_surface;
+}
+
+void tst_Bench_Gradient::colorTable_data()
+{
+    QTest::addColumn<int>("stopCount");
+
+    QTest::newRow("2 stops") << 2;
+    QTest::newRow("5 stops") << 5;
+    QTest::newRow("20 stops") << 20;
+    QTest::newRow("100 stops") << 100;
+}
+
+void tst_Bench_Gradient::colorTable()
+{
+    QFETCH(int, stopCount);
+
+    const QQuickPathRenderer::GradientDesc grad = gradient(stopCount, 0);
+    QVector<uint> buf(QQuickPathRenderer::GradientTableWidth);
+    BenchmarkCounter counter;
+    QBENCHMARK {
+        QQuickPathRenderer::generateGradientColorTable(grad.stops, buf.data(), buf.count(), 1.0f);
+        counter.next();
+    }
+    counter.report();
+}
+
+void tst_Bench_Gradient::cacheHit()
+{
+    if (!m_context)
+        QSKIP("OpenGL context not available");
+
+    QQuickPathGradientCache *cache = QQuickPathGradientCache::currentCache();
+    const QQuickPathRenderer::GradientTable tab = table(gradient(5, 0));
+    const int row = cache->acquireRow(tab);
+    cache->bind();
+
+    BenchmarkCounter counter;
+    QBENCHMARK {
+        cache->releaseRow(cache->acquireRow(tab));
+        cache->bind();
+        counter.next();
+    }
+    counter.report();
+    cache->releaseRow(row);
+}
+
+// Each iteration uses stops the cache has not seen yet, meaning a new color
+// table and uploading its row every time. The table is generated here like
+// the renderer does on the gui thread.
+void tst_Bench_Gradient::cacheMiss()
+{
+    if (!m_context)
+        QSKIP("OpenGL context not available");
+
+    QQuickPathGradientCache *cache = QQuickPathGradientCache::currentCache();
+    int variant = 1;
+
+    BenchmarkCounter counter;
+    QBENCHMARK {
+        cache->releaseRow(cache->acquireRow(table(gradient(5, variant))));
+        cache->bind();
+        ++variant;
+        counter.next();
+    }
+    counter.report();
+}
+
+// An item whose stops change every frame, with a few static gradients
+// around. The stale rows get evicted, the cache does not grow beyond its
+// budget.
+void tst_Bench_Gradient::animatedStops()
+{
+    if (!m_context)
+        QSKIP("OpenGL context not available");
+
+    QQuickPathGradientCache *cache = QQuickPathGradientCache::currentCache();
+    const int maxBytes = cache->maxBytes();
+    cache->setMaxBytes(64 * QQuickPathGradientCache::RowWidth * sizeof(uint));
+    const int initialBytes = cache->totalBytes();
+    cache->resetCounters();
+
+    QVector<int> staticRows;
+    for (int i = 0; i < 8; ++i)
+        staticRows.append(cache->acquireRow(table(gradient(2 + i, 0))));
+    int row = -1;
+    int variant = 1;
+
+    BenchmarkCounter counter;
+    QBENCHMARK {
+        const int next = cache->acquireRow(table(gradient(5, variant)));
+        cache->releaseRow(row);
+        row = next;
+        cache->bind();
+        ++variant;
+        counter.next();
+    }
+    counter.report();
+
+    qInfo("%d hits, %d misses, %d evictions, %d KB", cache->hits(), cache->misses(), cache->evictions(),
+          cache->totalBytes() / 1024);
+    QVERIFY(cache->totalBytes() <= qMax(initialBytes, cache->maxBytes()));
+
+    cache->releaseRow(row);
+    for (int r : staticRows)
+        cache->releaseRow(r);
+    cache->setMaxBytes(maxBytes);
+}
+
+QTEST_MAIN(tst_Bench_Gradient)
+
+#include "tst_bench_gradient.moc"
@@ -0,0 +1,8 @@
+CONFIG += benchmark
+TEMPLATE = app
+TARGET = tst_bench_pathdata
+QT = core gui testlib qml quick quickpath-private
+
+SOURCES += tst_bench_pathdata.cpp
+
+include(../shared/shared.pri)
@@ -0,0 +1,242 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the QtQuickPath module
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QQmlEngine>
+#include <QtQuickPath/private/qquickpathitem_p.h>
+#include <QtQuickPath/private/qquickpathsvgparser_p.h>
+
+#include "benchmarkcounter.h"
+#include "pathcorpus.h"
+
+// Building a path of pointCount elements from script, once with a call per
+// element and once with a single setPathData(), and the same from C++.
+// parseSvg() measures the SVG path data parser on about a megabyte of text.
+
+class tst_Bench_PathData : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void fromScript_data();
+    void fromScript();
+    void fromCpp_data();
+    void fromCpp();
+    void parseSvg_data();
+    void parseSvg();
+
+private:
+    static QString mapPathData(int minLength);
+    static QString iconPathData(int minLength);
+
+    QQmlEngine *m_engine;
+    QQuickPathItem *m_item;
+};
+
+void tst_Bench_PathData::initTestCase()
+{
+    m_engine = new QQmlEngine;
+    m_item = new QQuickPathItem;
+    QQmlEngine::setObjectOwnership(m_item, QQmlEngine::CppOwnership);
+    m_engine->globalObject().setProperty(QStringLiteral("item"), m_engine->newQObject(m_item));
+}
+
+void tst_Bench_PathData::cleanupTestCase()
+{
+    delete m_engine;
+    delete m_item;
+}
+
+static void addRows()
+{
+    QTest::addColumn<int>("pointCount");
+    QTest::addColumn<bool>("bulk");
+
+    for (int pointCount : { 100, 1000, 10000 }) {
+        QTest::newRow(qPrintable(QString::fromLatin1("%1 points, per call").arg(pointCount))) << pointCount << false;
+        QTest::newRow(qPrintable(QString::fromLatin1("%1 points, setPathData").arg(pointCount))) << pointCount << true;
+    }
+}
+
+void tst_Bench_PathData::fromScript_data()
+{
+    addRows();
+}
+
+void tst_Bench_PathData::fromScript()
+{
+    QFETCH(int, pointCount);
+    QFETCH(bool, bulk);
+
+    // the per call variant goes through the Q_INVOKABLEs, the bulk one fills
+    // the typed arrays in script and hands them over at once
+    QJSValue build = m_engine->evaluate(bulk ?
+        QStringLiteral("(function(n) {"
+                       "    var cmds = new Uint8Array(n);"
+                       "    var coords = new Float32Array(2 * n);"
+                       "    for (var i = 0; i < n; ++i) {"
+                       "        cmds[i] = i ? 1 : 0;"
+                       "        coords[2 * i] = i;"
+                       "        coords[2 * i + 1] = (i & 1) * 200;"
+                       "    }"
+                       "    item.setPathData(cmds, coords);"
+                       "})")
+        : QStringLiteral("(function(n) {"
+                         "    item.clear();"
+                         "    item.moveTo(0, 0);"
+                         "    for (var i = 1; i < n; ++i)"
+                         "        item.lineTo(i, (i & 1) * 200);"
+                         "})"));
+    QVERIFY(build.isCallable());
+
+    BenchmarkCounter counter;
+    QBENCHMARK {
+        build.call(QJSValueList() << pointCount);
+        counter.next();
+    }
+    counter.report();
+    QCOMPARE(m_item->isEmpty(), false);
+}
+
+void tst_Bench_PathData::fromCpp_data()
+{
+    addRows();
+}
+
+void tst_Bench_PathData::fromCpp()
+{
+    QFETCH(int, pointCount);
+    QFETCH(bool, bulk);
+
+    QByteArray commands(pointCount, char(QQuickPathItem::LineToCommand));
+    commands[0] = char(QQuickPathItem::MoveToCommand);
+    QVector<float> coords(2 * pointCount);
+    for (int i = 0; i < pointCount; ++i) {
+        coords[2 * i] = i;
+        coords[2 * i + 1] = (i & 1) * 200;
+    }
+
+    BenchmarkCounter counter;
+    QBENCHMARK {
+        if (bulk) {
+            m_item->setPathData(reinterpret_cast<const quint8 *>(commands.constData()), commands.size(),
+                                coords.constData(), coords.size());
+        } else {
+            m_item->clear();
+            m_item->moveTo(coords[0], coords[1]);
+            for (int i = 1; i < pointCount; ++i)
+                m_item->lineTo(coords[2 * i], coords[2 * i + 1]);
+        }
+        counter.next();
+    }
+    counter.report();
+}
+
+// Coastlines the way map exports look: a moveto per polygon and relative
+// lines with two decimals.
+QString tst_Bench_PathData::mapPathData(int minLength)
+{
+    const QPainterPath coast = PathCorpus::coastline(2000);
+    QByteArray data;
+    char buf[64];
+    for (int n = 0; data.size() < minLength; ++n) {
+        const QPointF offset((n % 10) * 1100, (n / 10) * 700);
+        QPointF last;
+        for (int i = 0; i < coast.elementCount(); ++i) {
+            const QPainterPath::Element &e = coast.elementAt(i);
+            const QPointF pt = QPointF(e.x, e.y) + offset;
+            if (e.isMoveTo())
+                qsnprintf(buf, sizeof(buf), "\nM%.2f,%.2f", pt.x(), pt.y());
+            else
+                qsnprintf(buf, sizeof(buf), " l%.2f,%.2f", pt.x() - last.x(), pt.y() - last.y());
+            data += buf;
+            last = pt;
+        }
+        data += 'z';
+    }
+    return QString::fromLatin1(data);
+}
+
+// Icon sets are minified, with implicit separators, smooth curves and arcs.
+QString tst_Bench_PathData::iconPathData(int minLength)
+{
+    QByteArray data;
+    char buf[256];
+    for (int n = 0; data.size() < minLength; ++n) {
+        qsnprintf(buf, sizeof(buf),
+                  "M%d %dh24v24h-24z"
+                  "m12 2a10 10 0 1 1-.01 0zm-6.5 9.5c1.5-2 3.5-2 5 0s3.5 2 5 0"
+                  "M%d %dq2 3 4 0t4 0 4 0l-1.5.5-.25-1.75A3.5 3.5 0 0 0 %d.5 %d.25Z",
+                  (n % 100) * 30, (n / 100) * 30,
+                  (n % 100) * 30 + 2, (n / 100) * 30 + 20,
+                  (n % 100) * 30 + 8, (n / 100) * 30 + 6);
+        data += buf;
+    }
+    return QString::fromLatin1(data);
+}
+
+void tst_Bench_PathData::parseSvg_data()
+{
+    QTest::addColumn<QString>("data");
+
+    QTest::newRow("map, 1 MB") << mapPathData(1 << 20);
+    QTest::newRow("icons, 1 MB") << iconPathData(1 << 20);
+}
+
+void tst_Bench_PathData::parseSvg()
+{
+    QFETCH(QString, data);
+
+    QPainterPath path;
+    QVERIFY(QQuickPathSvgParser::parse(data, &path));
+    const int elementCount = path.elementCount();
+
+    BenchmarkCounter counter;
+    QBENCHMARK {
+        path = QPainterPath();
+        QQuickPathSvgParser::parse(data, &path);
+        counter.next();
+    }
+    counter.report();
+    QCOMPARE(path.elementCount(), elementCount);
+}
+
+QTEST_MAIN(tst_Bench_PathData)
+
+#include "tst_bench_pathdata.moc"
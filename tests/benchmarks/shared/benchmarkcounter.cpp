@@ -0,0 +1,225 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the QtQuickPath module
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "benchmarkcounter.h"
+#include <QDebug>
+
+#if defined(__GLIBC__)
+
+#include <stdlib.h>
+#include <malloc.h>
+#include <errno.h>
+#include <unistd.h>
+
+// glibc allows replacing the allocator functions in the executable, forward
+// to the real implementation while keeping count. This catches QVector and
+// friends, which do not go through operator new. Every function that hands
+// out memory free() accepts is replaced, otherwise the live bytes would not
+// balance.
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+extern "C" void *__libc_memalign(size_t alignment, size_t size);
+extern "C" void __libc_free(void *ptr);
+
+static QBasicAtomicInteger<quint64> qt_bench_allocated_bytes = Q_BASIC_ATOMIC_INITIALIZER(0);
+static QBasicAtomicInteger<quint64> qt_bench_live_bytes = Q_BASIC_ATOMIC_INITIALIZER(0);
+static QBasicAtomicInteger<quint64> qt_bench_peak_bytes = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+static void addLiveBytes(void *ptr)
+{
+    if (!ptr)
+        return;
+    const quint64 size = malloc_usable_size(ptr);
+    const quint64 live = qt_bench_live_bytes.fetchAndAddRelaxed(size) + size;
+    quint64 peak = qt_bench_peak_bytes.load();
+    while (live > peak && !qt_bench_peak_bytes.testAndSetRelaxed(peak, live, peak)) { }
+}
+
+static void removeLiveBytes(void *ptr)
+{
+    if (ptr)
+        qt_bench_live_bytes.fetchAndSubRelaxed(malloc_usable_size(ptr));
+}
+
+extern "C" void *malloc(size_t size)
+{
+    qt_bench_allocated_bytes.fetchAndAddRelaxed(size);
+    void *ptr = __libc_malloc(size);
+    addLiveBytes(ptr);
+    return ptr;
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    qt_bench_allocated_bytes.fetchAndAddRelaxed(count * size);
+    void *ptr = __libc_calloc(count, size);
+    addLiveBytes(ptr);
+    return ptr;
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    qt_bench_allocated_bytes.fetchAndAddRelaxed(size);
+    removeLiveBytes(ptr);
+    ptr = __libc_realloc(ptr, size);
+    addLiveBytes(ptr);
+    return ptr;
+}
+
+// the aligned variants only need to be seen so that free() stays balanced
+extern "C" void *memalign(size_t alignment, size_t size)
+{
+    qt_bench_allocated_bytes.fetchAndAddRelaxed(size);
+    void *ptr = __libc_memalign(alignment, size);
+    addLiveBytes(ptr);
+    return ptr;
+}
+
+extern "C" int posix_memalign(void **ptr, size_t alignment, size_t size)
+{
+    *ptr = memalign(alignment, size);
+    return *ptr || !size ? 0 : ENOMEM;
+}
+
+extern "C" void *aligned_alloc(size_t alignment, size_t size)
+{
+    return memalign(alignment, size);
+}
+
+extern "C" void *valloc(size_t size)
+{
+    return memalign(sysconf(_SC_PAGESIZE), size);
+}
+
+extern "C" void *pvalloc(size_t size)
+{
+    const size_t page = sysconf(_SC_PAGESIZE);
+    return memalign(page, (size + page - 1) & ~(page - 1));
+}
+
+extern "C" void *reallocarray(void *ptr, size_t count, size_t size)
+{
+    if (size && count > size_t(-1) / size) {
+        errno = ENOMEM;
+        return nullptr;
+    }
+    return realloc(ptr, count * size);
+}
+
+extern "C" void free(void *ptr)
+{
+    removeLiveBytes(ptr);
+    __libc_free(ptr);
+}
+
+bool BenchmarkCounter::allocationCountingSupported()
+{
+    return true;
+}
+
+quint64 BenchmarkCounter::allocatedBytes()
+{
+    return qt_bench_allocated_bytes.load();
+}
+
+quint64 BenchmarkCounter::liveBytes()
+{
+    return qt_bench_live_bytes.load();
+}
+
+quint64 BenchmarkCounter::peakBytes()
+{
+    return qt_bench_peak_bytes.load();
+}
+
+void BenchmarkCounter::resetPeakBytes()
+{
+    qt_bench_peak_bytes.store(qt_bench_live_bytes.load());
+}
+
+#else
+
+bool BenchmarkCounter::allocationCountingSupported()
+{
+    return false;
+}
+
+quint64 BenchmarkCounter::allocatedBytes()
+{
+    return 0;
+}
+
+quint64 BenchmarkCounter::liveBytes()
+{
+    return 0;
+}
+
+quint64 BenchmarkCounter::peakBytes()
+{
+    return 0;
+}
+
+void BenchmarkCounter::resetPeakBytes()
+{
+}
+
+#endif
+
+BenchmarkCounter::BenchmarkCounter()
+    : m_startBytes(allocatedBytes()),
+      m_iterations(0)
+{
+    m_timer.start();
+}
+
+void BenchmarkCounter::report(qint64 verticesPerCall) const
+{
+    if (!m_iterations)
+        return;
+
+    if (verticesPerCall > 0) {
+        const qint64 nsecs = m_timer.nsecsElapsed();
+        const double verticesPerSec = nsecs ? verticesPerCall * m_iterations * 1e9 / nsecs : 0;
+        qInfo("%lld vertices, %.0f vertices/sec", verticesPerCall, verticesPerSec);
+    }
+
+    if (allocationCountingSupported()) {
+        const quint64 bytesPerCall = (allocatedBytes() - m_startBytes) / m_iterations;
+        qInfo("%llu bytes allocated per call", bytesPerCall);
+    }
+}
@@ -0,0 +1,79 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the QtQuickPath module
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef BENCHMARKCOUNTER_H
+#define BENCHMARKCOUNTER_H
+
+#include <QElapsedTimer>
+#include <QtGlobal>
+
+// Counts the iterations of a QBENCHMARK loop together with the time spent
+// and the heap memory requested meanwhile, and prints the per-call
+// throughput figures QTest itself does not report.
+//
+//     BenchmarkCounter counter;
+//     QBENCHMARK {
+//         doWork();
+//         counter.next();
+//     }
+//     counter.report(verticesProducedPerCall);
+
+class BenchmarkCounter
+{
+public:
+    BenchmarkCounter();
+
+    void next() { ++m_iterations; }
+    // verticesPerCall can be 0 when there is no geometry involved
+    void report(qint64 verticesPerCall = 0) const;
+
+    // false when the platform does not allow counting the allocations
+    static bool allocationCountingSupported();
+    // total number of bytes requested from malloc() and friends so far
+    static quint64 allocatedBytes();
+    // heap memory in use now, and the most that was in use at any time
+    // since the last resetPeakBytes()
+    static quint64 liveBytes();
+    static quint64 peakBytes();
+    static void resetPeakBytes();
+
+private:
+    QElapsedTimer m_timer;
+    quint64 m_startBytes;
+    qint64 m_iterations;
+};
+
+#endif
@@ -0,0 +1,242 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the QtQuickPath module
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef PATHCORPUS_H
+#define PATHCORPUS_H
+
+#include <QPainterPath>
+#include <QFont>
+#include <QVector>
+#include <QString>
+#include <qmath.h>
+
+// A fixed set of paths the benchmarks run on. Everything is generated, with
+// a private random number generator so that the results are comparable
+// between runs and platforms.
+
+namespace PathCorpus {
+
+class Random
+{
+public:
+    Random(quint32 seed) : m_state(seed) { }
+    // [0, 1)
+    qreal next()
+    {
+        m_state = m_state * 1664525u + 1013904223u;
+        return (m_state >> 8) / qreal(1 << 24);
+    }
+
+private:
+    quint32 m_state;
+};
+
+inline QPainterPath polyline(int pointCount, bool closed)
+{
+    Random r(1);
+    QPainterPath p;
+    p.moveTo(0, 0);
+    for (int i = 1; i < pointCount; ++i)
+        p.lineTo(i * 1000.0 / pointCount, (i & 1) * 200 + r.next() * 100);
+    if (closed) {
+        p.lineTo(1000, 600);
+        p.lineTo(0, 600);
+        p.closeSubpath();
+    }
+    return p;
+}
+
+// a {n/2} star polygon, self-intersecting
+inline QPainterPath starPolygon(int pointCount)
+{
+    QPainterPath p;
+    const int step = pointCount / 2 - (pointCount % 2 ? 0 : 1);
+    for (int i = 0; i < pointCount; ++i) {
+        const qreal a = 2 * M_PI * ((i * step) % pointCount) / pointCount;
+        const QPointF pt(500 + 400 * qCos(a), 500 + 400 * qSin(a));
+        if (i == 0)
+            p.moveTo(pt);
+        else
+            p.lineTo(pt);
+    }
+    p.closeSubpath();
+    return p;
+}
+
+inline QPainterPath textOutline()
+{
+    QPainterPath p;
+    QFont font(QStringLiteral("sans-serif"));
+    font.setPixelSize(48);
+    p.addText(0, 48, font, QStringLiteral("The quick brown fox jumps over the lazy dog"));
+    return p;
+}
+
+// A closed coastline-like shape built by midpoint displacement.
+inline QPainterPath coastline(int pointCount)
+{
+    Random r(42);
+    QVector<QPointF> pts;
+    pts.reserve(pointCount);
+    for (int i = 0; i < 8; ++i) {
+        const qreal a = 2 * M_PI * i / 8;
+        pts.append(QPointF(500 + 400 * qCos(a), 500 + 400 * qSin(a)));
+    }
+    qreal roughness = 0.35;
+    while (pts.count() < pointCount) {
+        const int insertCount = qMin(pts.count(), pointCount - pts.count());
+        QVector<QPointF> refined;
+        refined.reserve(pts.count() + insertCount);
+        for (int i = 0; i < pts.count(); ++i) {
+            const QPointF &a = pts.at(i);
+            refined.append(a);
+            if (i < insertCount) {
+                const QPointF &b = pts.at((i + 1) % pts.count());
+                const QPointF d = b - a;
+                const QPointF normal(-d.y(), d.x());
+                refined.append((a + b) / 2 + normal * (r.next() - 0.5) * roughness);
+            }
+        }
+        pts = refined;
+        roughness *= 0.9;
+    }
+
+    QPainterPath p;
+    p.moveTo(pts.first());
+    for (int i = 1; i < pts.count(); ++i)
+        p.lineTo(pts.at(i));
+    p.closeSubpath();
+    return p;
+}
+
+// a spiral made of many short cubic segments
+inline QPainterPath denseCubics(int segmentCount)
+{
+    QPainterPath p;
+    p.moveTo(500, 500);
+    for (int i = 0; i < segmentCount; ++i) {
+        const qreal a = i * 0.3;
+        const qreal r = 5 + i * 400.0 / segmentCount;
+        const QPointF c(500, 500);
+        const QPointF e = c + QPointF(qCos(a + 0.3), qSin(a + 0.3)) * r;
+        const QPointF c1 = c + QPointF(qCos(a + 0.1), qSin(a + 0.1)) * r * 1.1;
+        const QPointF c2 = c + QPointF(qCos(a + 0.2), qSin(a + 0.2)) * r * 0.9;
+        p.cubicTo(c1, c2, e);
+    }
+    p.closeSubpath();
+    return p;
+}
+
+// the shapes typical user interfaces are made of
+
+inline QPainterPath roundedButton()
+{
+    QPainterPath p;
+    p.addRoundedRect(QRectF(0, 0, 120, 40), 8, 8);
+    return p;
+}
+
+inline QPainterPath ellipse()
+{
+    QPainterPath p;
+    p.addEllipse(QRectF(0, 0, 200, 100));
+    return p;
+}
+
+inline QPainterPath pieSlice()
+{
+    QPainterPath p;
+    p.moveTo(50, 50);
+    p.arcTo(QRectF(0, 0, 100, 100), 30, 60);
+    p.closeSubpath();
+    return p;
+}
+
+inline QPainterPath arrow()
+{
+    QPainterPath p;
+    p.moveTo(0, 15);
+    p.lineTo(60, 15);
+    p.lineTo(60, 0);
+    p.lineTo(100, 25);
+    p.lineTo(60, 50);
+    p.lineTo(60, 35);
+    p.lineTo(0, 35);
+    p.closeSubpath();
+    return p;
+}
+
+// a concave but not self-intersecting star outline
+inline QPainterPath starOutline(int spikes)
+{
+    QPainterPath p;
+    for (int i = 0; i < spikes * 2; ++i) {
+        const qreal a = M_PI * i / spikes;
+        const qreal r = i % 2 ? 20 : 50;
+        const QPointF pt(50 + r * qCos(a), 50 + r * qSin(a));
+        if (i == 0)
+            p.moveTo(pt);
+        else
+            p.lineTo(pt);
+    }
+    p.closeSubpath();
+    return p;
+}
+
+struct Entry {
+    const char *name;
+    QPainterPath path;
+};
+
+inline QVector<Entry> all()
+{
+    QVector<Entry> corpus;
+    corpus.append({ "polyline-100", polyline(100, true) });
+    corpus.append({ "polyline-10000", polyline(10000, true) });
+    corpus.append({ "star-5", starPolygon(5) });
+    corpus.append({ "star-51", starPolygon(51) });
+    corpus.append({ "star-501", starPolygon(501) });
+    corpus.append({ "text", textOutline() });
+    corpus.append({ "coastline-1000", coastline(1000) });
+    corpus.append({ "coastline-20000", coastline(20000) });
+    corpus.append({ "cubics-100", denseCubics(100) });
+    corpus.append({ "cubics-2000", denseCubics(2000) });
+    return corpus;
+}
+
+} // namespace PathCorpus
+
+#endif
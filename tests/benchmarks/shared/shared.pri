@@ -0,0 +1,6 @@
+INCLUDEPATH += $$PWD
+
+HEADERS += $$PWD/pathcorpus.h \
+           $$PWD/benchmarkcounter.h
+
+SOURCES += $$PWD/benchmarkcounter.cpp
@@ -0,0 +1,664 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the QtQuickPath module
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtGui/private/qpainterpath_p.h>
+#include <QtGui/private/qtriangulator_p.h>
+#include <QtQuickPath/private/qquickpathrendernode_p.h>
+#include <QtQuickPath/private/qquickpathtriangulationcache_p.h>
+#include <QtQuickPath/private/qquickpathstencilrenderer_p.h>
+#include <QtQuickPath/private/qquickpathextrudedstrokematerial_p.h>
+#include <QtQuickPath/private/qquickpathitem_p.h>
+#include <QQuickWindow>
+#include <QSGRendererInterface>
+#include <climits>
+
+#include "pathcorpus.h"
+#include "benchmarkcounter.h"
+
+class tst_Bench_Triangulation : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void fill_data();
+    void fill();
+    void fillByClass_data();
+    void fillByClass();
+    void stencilFans_data();
+    void stencilFans();
+    void fillScaled_data();
+    void fillScaled();
+    void fillAntialiased_data();
+    void fillAntialiased();
+    void curveFill_data();
+    void curveFill();
+    void curveFillScaled_data();
+    void curveFillScaled();
+    void strokeSolid_data();
+    void strokeSolid();
+    void strokeAntialiased_data();
+    void strokeAntialiased();
+    void strokeExtruded_data();
+    void strokeExtruded();
+    void strokeDashed_data();
+    void strokeDashed();
+    void trimmedRings_data();
+    void trimmedRings();
+    void editedMap_data();
+    void editedMap();
+    void primitives_data();
+    void primitives();
+
+    void largeFill_data();
+    void largeFill();
+
+    void cachedFill_data();
+    void cachedFill();
+
+    void uploadMemory_data();
+    void uploadMemory();
+
+private:
+    void corpusData();
+
+    QVector<PathCorpus::Entry> m_corpus;
+    QSizeF m_clipSize;
+};
+
+static const QQuickPathRenderer::Color4ub color = { 255, 0, 0, 255 };
+
+void tst_Bench_Triangulation::initTestCase()
+{
+    m_corpus = PathCorpus::all();
+    m_clipSize = QSizeF(1920, 1080);
+}
+
+void tst_Bench_Triangulation::corpusData()
+{
+    QTest::addColumn<int>("index");
+    for (int i = 0; i < m_corpus.count(); ++i)
+        QTest::newRow(m_corpus.at(i).name) << i;
+}
+
+void tst_Bench_Triangulation::fill_data()
+{
+    corpusData();
+}
+
+void tst_Bench_Triangulation::fill()
+{
+    QFETCH(int, index);
+    const QVectorPath &vp = qtVectorPathForPath(m_corpus.at(index).path);
+
+    QQuickPathRenderer::FillGeometry fill;
+    BenchmarkCounter counter;
+    QBENCHMARK {
+        QQuickPathRenderer::triangulateFill(vp, color, &fill, false);
+        counter.next();
+    }
+    counter.report(fill.vertices.count());
+}
+
+void tst_Bench_Triangulation::fillByClass_data()
+{
+    QTest::addColumn<QString>("shape");
+    QTest::addColumn<bool>("reference");
+
+    // Convex shapes get a triangle fan, small simple polygons are ear
+    // clipped, the rest goes through qTriangulate(). The reference rows call
+    // qTriangulate() directly, for comparison.
+    const char *shapes[] = {
+        "convex-button", "convex-ellipse", "convex-pie",
+        "simple-arrow", "simple-star-10", "simple-star-30",
+        "general-star-5", "general-text"
+    };
+    for (const char *shape : shapes) {
+        QTest::newRow(QByteArray(shape) + "-fast") << QString::fromLatin1(shape) << false;
+        QTest::newRow(QByteArray(shape) + "-qTriangulate") << QString::fromLatin1(shape) << true;
+    }
+}
+
+void tst_Bench_Triangulation::fillByClass()
+{
+    QFETCH(QString, shape);
+    QFETCH(bool, reference);
+
+    QPainterPath path;
+    if (shape == QLatin1String("convex-button"))
+        path = PathCorpus::roundedButton();
+    else if (shape == QLatin1String("convex-ellipse"))
+        path = PathCorpus::ellipse();
+    else if (shape == QLatin1String("convex-pie"))
+        path = PathCorpus::pieSlice();
+    else if (shape == QLatin1String("simple-arrow"))
+        path = PathCorpus::arrow();
+    else if (shape == QLatin1String("simple-star-10"))
+        path = PathCorpus::starOutline(5);
+    else if (shape == QLatin1String("simple-star-30"))
+        path = PathCorpus::starOutline(15);
+    else if (shape == QLatin1String("general-star-5"))
+        path = PathCorpus::starPolygon(5);
+    else
+        path = PathCorpus::textOutline();
+    const QVectorPath &vp = qtVectorPathForPath(path);
+
+    BenchmarkCounter counter;
+    if (reference) {
+        QTriangleSet ts;
+        QBENCHMARK {
+            ts = qTriangulate(vp, QTransform::fromScale(100, 100));
+            counter.next();
+        }
+        counter.report(ts.vertices.count() / 2);
+    } else {
+        QQuickPathRenderer::FillGeometry fill;
+        QBENCHMARK {
+            QQuickPathRenderer::triangulateFill(vp, color, &fill, false);
+            counter.next();
+        }
+        counter.report(fill.vertices.count());
+    }
+}
+
+void tst_Bench_Triangulation::stencilFans_data()
+{
+    corpusData();
+}
+
+// the CPU side of stencil-then-cover filling, compare with fill()
+void tst_Bench_Triangulation::stencilFans()
+{
+    QFETCH(int, index);
+    const QPainterPath &path(m_corpus.at(index).path);
+
+    QQuickPathStencilRenderer::VertexContainer vertices;
+    QRectF bounds;
+    BenchmarkCounter counter;
+    QBENCHMARK {
+        QQuickPathStencilRenderer::generateFillFans(path, 1, &vertices, &bounds);
+        counter.next();
+    }
+    counter.report(vertices.count());
+}
+
+void tst_Bench_Triangulation::fillScaled_data()
+{
+    QTest::addColumn<qreal>("scale");
+
+    QTest::newRow("0.25x") << qreal(0.25);
+    QTest::newRow("1x") << qreal(1);
+    QTest::newRow("4x") << qreal(4);
+    QTest::newRow("16x") << qreal(16);
+}
+
+// curve flattening follows the scale to device pixels
+void tst_Bench_Triangulation::fillScaled()
+{
+    QFETCH(qreal, scale);
+    const QVectorPath &vp = qtVectorPathForPath(PathCorpus::textOutline());
+
+    QQuickPathRenderer::FillGeometry fill;
+    BenchmarkCounter counter;
+    QBENCHMARK {
+        QQuickPathRenderer::triangulateFill(vp, color, &fill, false, false, scale);
+        counter.next();
+    }
+    counter.report(fill.vertices.count());
+}
+
+void tst_Bench_Triangulation::fillAntialiased_data()
+{
+    corpusData();
+}
+
+void tst_Bench_Triangulation::fillAntialiased()
+{
+    QFETCH(int, index);
+    const QVectorPath &vp = qtVectorPathForPath(m_corpus.at(index).path);
+
+    QQuickPathRenderer::FillGeometry fill;
+    BenchmarkCounter counter;
+    QBENCHMARK {
+        QQuickPathRenderer::triangulateFill(vp, color, &fill, false, true);
+        counter.next();
+    }
+    counter.report(fill.vertices.count() + fill.fringe.count());
+}
+
+void tst_Bench_Triangulation::curveFill_data()
+{
+    corpusData();
+}
+
+// curves evaluated in the fragment shader, compare with fill()
+void tst_Bench_Triangulation::curveFill()
+{
+    QFETCH(int, index);
+    const QVectorPath &vp = qtVectorPathForPath(m_corpus.at(index).path);
+
+    QQuickPathRenderer::FillGeometry fill;
+    BenchmarkCounter counter;
+    QBENCHMARK {
+        if (!QQuickPathRenderer::triangulateCurveFill(vp, color, &fill, false))
+            QQuickPathRenderer::triangulateFill(vp, color, &fill, false);
+        counter.next();
+    }
+    counter.report(fill.curveVertices.isEmpty() ? fill.vertices.count() : fill.curveVertices.count());
+}
+
+void tst_Bench_Triangulation::curveFillScaled_data()
+{
+    fillScaled_data();
+}
+
+// compare with fillScaled(), only cubics depend on the scale here
+void tst_Bench_Triangulation::curveFillScaled()
+{
+    QFETCH(qreal, scale);
+    const QVectorPath &vp = qtVectorPathForPath(PathCorpus::textOutline());
+
+    QQuickPathRenderer::FillGeometry fill;
+    BenchmarkCounter counter;
+    QBENCHMARK {
+        QQuickPathRenderer::triangulateCurveFill(vp, color, &fill, false, scale);
+        counter.next();
+    }
+    counter.report(fill.curveVertices.count());
+}
+
+void tst_Bench_Triangulation::strokeSolid_data()
+{
+    corpusData();
+}
+
+void tst_Bench_Triangulation::strokeSolid()
+{
+    QFETCH(int, index);
+    const QVectorPath &vp = qtVectorPathForPath(m_corpus.at(index).path);
+
+    QPen pen(Qt::black, 4, Qt::SolidLine, Qt::SquareCap, Qt::BevelJoin);
+    QQuickPathRenderer::VertexContainer vertices;
+    BenchmarkCounter counter;
+    QBENCHMARK {
+        QQuickPathRenderer::triangulateStroke(vp, pen, color, &vertices, m_clipSize);
+        counter.next();
+    }
+    counter.report(vertices.count());
+}
+
+void tst_Bench_Triangulation::strokeAntialiased_data()
+{
+    corpusData();
+}
+
+void tst_Bench_Triangulation::strokeAntialiased()
+{
+    QFETCH(int, index);
+    const QVectorPath &vp = qtVectorPathForPath(m_corpus.at(index).path);
+
+    QPen pen(Qt::black, 4, Qt::SolidLine, Qt::SquareCap, Qt::BevelJoin);
+    QQuickPathRenderer::VertexContainer vertices;
+    QQuickPathRenderer::FringeContainer fringe;
+    BenchmarkCounter counter;
+    QBENCHMARK {
+        QQuickPathRenderer::triangulateStroke(vp, pen, color, &vertices, m_clipSize, &fringe);
+        counter.next();
+    }
+    counter.report(vertices.count() + fringe.count());
+}
+
+void tst_Bench_Triangulation::strokeExtruded_data()
+{
+    corpusData();
+}
+
+// the width-independent stroke geometry, compare with strokeSolid()
+void tst_Bench_Triangulation::strokeExtruded()
+{
+    QFETCH(int, index);
+    const QVectorPath &vp = qtVectorPathForPath(m_corpus.at(index).path);
+
+    QPen pen(Qt::black, 4, Qt::SolidLine, Qt::SquareCap, Qt::BevelJoin);
+    QQuickPathRenderer::ExtrudedVertexContainer vertices;
+    BenchmarkCounter counter;
+    QBENCHMARK {
+        QQuickPathRenderer::extrudeStroke(vp, pen, color, &vertices);
+        counter.next();
+    }
+    counter.report(vertices.count());
+}
+
+void tst_Bench_Triangulation::strokeDashed_data()
+{
+    corpusData();
+}
+
+void tst_Bench_Triangulation::strokeDashed()
+{
+    QFETCH(int, index);
+    const QVectorPath &vp = qtVectorPathForPath(m_corpus.at(index).path);
+
+    QPen pen(Qt::black, 4, Qt::CustomDashLine, Qt::SquareCap, Qt::BevelJoin);
+    pen.setDashPattern(QVector<qreal>() << 4 << 2);
+    QQuickPathRenderer::VertexContainer vertices;
+    BenchmarkCounter counter;
+    QBENCHMARK {
+        QQuickPathRenderer::triangulateStroke(vp, pen, color, &vertices, m_clipSize);
+        counter.next();
+    }
+    counter.report(vertices.count());
+}
+
+void tst_Bench_Triangulation::trimmedRings_data()
+{
+    QTest::addColumn<bool>("extruded");
+    QTest::newRow("retessellated") << false;
+    QTest::newRow("extruded") << true;
+}
+
+// One animation frame of 500 rings with a changing strokeEnd. Extruded
+// strokes only update the material, the others trim and stroke the path.
+void tst_Bench_Triangulation::trimmedRings()
+{
+    QFETCH(bool, extruded);
+    const int ringCount = 500;
+    QPainterPath ring;
+    ring.addEllipse(QPointF(0, 0), 20, 20);
+    const QPen pen(Qt::black, 4, Qt::SolidLine, Qt::FlatCap, Qt::BevelJoin);
+
+    QVector<QQuickPathRenderer::ExtrudedVertexContainer> extrudedVertices(ringCount);
+    for (int i = 0; i < ringCount; ++i)
+        QQuickPathRenderer::extrudeStroke(qtVectorPathForPath(ring), pen, color, &extrudedVertices[i]);
+#ifndef QT_NO_OPENGL
+    QVector<QQuickPathExtrudedStrokeMaterial *> materials;
+    for (int i = 0; i < ringCount; ++i)
+        materials.append(new QQuickPathExtrudedStrokeMaterial);
+#else
+    if (extruded)
+        QSKIP("No OpenGL");
+#endif
+
+    QQuickPathRenderer::VertexContainer vertices;
+    int frame = 0;
+    BenchmarkCounter counter;
+    QBENCHMARK {
+        ++frame;
+        for (int i = 0; i < ringCount; ++i) {
+            const qreal end = ((frame + i) % 100) / 100.0;
+            if (extruded) {
+#ifndef QT_NO_OPENGL
+                materials[i]->setPen(pen, 0, end, true);
+#endif
+            } else {
+                const QPainterPath trimmed = QQuickPathRenderer::trimPath(ring, 0, end);
+                QQuickPathRenderer::triangulateStroke(qtVectorPathForPath(trimmed), pen, color,
+                                                      &vertices, m_clipSize);
+            }
+        }
+        counter.next();
+    }
+    counter.report(extruded ? extrudedVertices.first().count() : vertices.count());
+#ifndef QT_NO_OPENGL
+    qDeleteAll(materials);
+#endif
+}
+
+void tst_Bench_Triangulation::editedMap_data()
+{
+    QTest::addColumn<bool>("incremental");
+    QTest::addColumn<bool>("knownChange");
+    QTest::newRow("whole") << false << false;
+    QTest::newRow("incremental") << true << false;
+    QTest::newRow("incremental, known change") << true << true;
+}
+
+// A map layer of 400 separate polygons, rebuilt from scratch with one of them
+// moved in each iteration, like an editor dragging a node. With a known
+// change the elements that moved are passed along, like PathItem does when
+// only command properties changed.
+void tst_Bench_Triangulation::editedMap()
+{
+    QFETCH(bool, incremental);
+    QFETCH(bool, knownChange);
+    const int columns = 20;
+    const QPainterPath cell = PathCorpus::coastline(200);
+    const qreal cellScale = 0.045;
+
+    QQuickPathRenderer::FillGeometry fill;
+    QQuickPathRenderer::FillGeometry otherFill;
+    QQuickPathRenderer::FillPieceContainer pieces;
+    int frame = 0;
+    BenchmarkCounter counter;
+    QBENCHMARK {
+        ++frame;
+        QPainterPath map;
+        for (int i = 0; i < columns * columns; ++i) {
+            const qreal dx = i == frame % (columns * columns) ? frame % 3 : 0;
+            QTransform t = QTransform::fromTranslate((i % columns) * 60 + dx, (i / columns) * 60);
+            t.scale(cellScale, cellScale);
+            map.addPath(t.map(cell));
+        }
+        // the polygons moved in this and the previous iteration
+        const int cellElements = cell.elementCount();
+        const int moved = frame % (columns * columns);
+        const int previous = (frame - 1) % (columns * columns);
+        const int changedFirst = knownChange ? qMin(moved, previous) * cellElements : -1;
+        const int changedLast = (qMax(moved, previous) + 1) * cellElements - 1;
+        if (incremental)
+            QQuickPathRenderer::triangulateFillPieces(map, color, pieces, &pieces, &fill, &otherFill, false,
+                                                      false, 1, changedFirst, changedLast);
+        else
+            QQuickPathRenderer::triangulateFill(qtVectorPathForPath(map), color, &fill, false);
+        counter.next();
+    }
+    counter.report(fill.vertices.count());
+    QVERIFY(!fill.vertices.isEmpty());
+}
+
+void tst_Bench_Triangulation::primitives_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<bool>("reference");
+
+    QTest::newRow("button-analytic") << int(QQuickPathPrimitive::RoundedRectangle) << false;
+    QTest::newRow("button-path") << int(QQuickPathPrimitive::RoundedRectangle) << true;
+    QTest::newRow("ellipse-analytic") << int(QQuickPathPrimitive::Ellipse) << false;
+    QTest::newRow("ellipse-path") << int(QQuickPathPrimitive::Ellipse) << true;
+}
+
+// fill and stroke, as done on each geometry change of a PathItem
+void tst_Bench_Triangulation::primitives()
+{
+    QFETCH(int, type);
+    QFETCH(bool, reference);
+
+    QQuickPathPrimitive primitive;
+    primitive.type = QQuickPathPrimitive::Type(type);
+    QPainterPath path;
+    if (primitive.type == QQuickPathPrimitive::Ellipse) {
+        primitive.rect = QRectF(0, 0, 200, 100);
+        primitive.radiusX = primitive.radiusY = 0;
+        path = PathCorpus::ellipse();
+    } else {
+        primitive.rect = QRectF(0, 0, 120, 40);
+        primitive.radiusX = primitive.radiusY = 8;
+        path = PathCorpus::roundedButton();
+    }
+    const QVector<QQuickPathPrimitive> primitives(1, primitive);
+    const QVectorPath &vp = qtVectorPathForPath(path);
+
+    QPen pen(Qt::black, 2, Qt::SolidLine, Qt::SquareCap, Qt::MiterJoin);
+    QQuickPathRenderer::FillGeometry fill;
+    QQuickPathRenderer::VertexContainer vertices;
+    BenchmarkCounter counter;
+    QBENCHMARK {
+        if (reference) {
+            QQuickPathRenderer::triangulateFill(vp, color, &fill, false);
+            QQuickPathRenderer::triangulateStroke(vp, pen, color, &vertices, m_clipSize);
+        } else {
+            QQuickPathRenderer::generatePrimitiveFill(primitives, color, 1, &fill);
+            QQuickPathRenderer::generatePrimitiveStroke(primitives, pen, color, 1, &vertices);
+        }
+        counter.next();
+    }
+    counter.report(fill.vertices.count() + vertices.count());
+}
+
+void tst_Bench_Triangulation::largeFill_data()
+{
+    QTest::addColumn<int>("pointCount");
+    QTest::addColumn<bool>("elementIndexUint");
+
+    QTest::newRow("100k, ushort") << 100000 << false;
+    QTest::newRow("100k, uint") << 100000 << true;
+    QTest::newRow("250k, ushort") << 250000 << false;
+    QTest::newRow("250k, uint") << 250000 << true;
+    QTest::newRow("500k, ushort") << 500000 << false;
+    QTest::newRow("500k, uint") << 500000 << true;
+    QTest::newRow("1M, ushort") << 1000000 << false;
+    QTest::newRow("1M, uint") << 1000000 << true;
+}
+
+// Exercises the path where the mesh exceeds 64K vertices and has to be
+// either split up into multiple ranges or indexed with 32-bit indices.
+void tst_Bench_Triangulation::largeFill()
+{
+    QFETCH(int, pointCount);
+    QFETCH(bool, elementIndexUint);
+
+    const QPainterPath path = PathCorpus::coastline(pointCount);
+    const QVectorPath &vp = qtVectorPathForPath(path);
+
+    QQuickPathRenderer::FillGeometry fill;
+    BenchmarkCounter counter;
+    QBENCHMARK {
+        QQuickPathRenderer::triangulateFill(vp, color, &fill, elementIndexUint);
+        counter.next();
+    }
+    counter.report(fill.vertices.count());
+    QVERIFY(!fill.vertices.isEmpty());
+}
+
+void tst_Bench_Triangulation::cachedFill_data()
+{
+    corpusData();
+}
+
+// The cost of a cache hit: hashing the path and comparing it with the stored one.
+void tst_Bench_Triangulation::cachedFill()
+{
+    QFETCH(int, index);
+    const QPainterPath &path(m_corpus.at(index).path);
+
+    QQuickPathTriangulationCache cache;
+    cache.setMaxBytes(64 * 1024 * 1024);
+    QQuickPathRenderer::FillGeometry fill;
+    QQuickPathRenderer::triangulateFill(qtVectorPathForPath(path), color, &fill, false);
+    cache.insertFill(QQuickPathTriangulationCache::fillKey(path, false, false, false, 1), fill);
+
+    // a deep copy, so that the comparison cannot take the shortcut of shared data
+    QPainterPath other;
+    other.setFillRule(path.fillRule());
+    other.addPath(path);
+
+    BenchmarkCounter counter;
+    QBENCHMARK {
+        cache.findFill(QQuickPathTriangulationCache::fillKey(other, false, false, false, 1), &fill);
+        counter.next();
+    }
+    counter.report(fill.vertices.count());
+    QCOMPARE(cache.misses(), 0);
+}
+
+void tst_Bench_Triangulation::uploadMemory_data()
+{
+    QTest::addColumn<bool>("release");
+
+    QTest::newRow("kept after upload") << false;
+    QTest::newRow("released after upload") << true;
+}
+
+// Not a timing: the heap in use while a 500k vertex fill gets generated and
+// uploaded to the scenegraph, and what stays in use afterwards.
+void tst_Bench_Triangulation::uploadMemory()
+{
+    QFETCH(bool, release);
+    if (!BenchmarkCounter::allocationCountingSupported())
+        QSKIP("Memory use cannot be measured on this platform");
+
+    const int threshold = QQuickPathRenderer::releaseThreshold();
+    QQuickPathRenderer::setReleaseThreshold(release ? 0 : INT_MAX);
+    QQuickPathTriangulationCache *cache = QQuickPathTriangulationCache::instance();
+    const int cacheSize = cache->maxBytes();
+    cache->setMaxBytes(0);
+
+    const QPainterPath path = PathCorpus::coastline(500000);
+    {
+        QQuickWindow window;
+        window.resize(1000, 1000);
+        QQuickPathItem *item = new QQuickPathItem(window.contentItem());
+        item->setSize(QSizeF(1000, 1000));
+        item->setStrokeWidth(0);
+        item->moveTo(path.elementAt(0).x, path.elementAt(0).y);
+        for (int i = 1; i < path.elementCount(); ++i)
+            item->lineTo(path.elementAt(i).x, path.elementAt(i).y);
+
+        QSignalSpy frames(&window, &QQuickWindow::frameSwapped);
+        const quint64 before = BenchmarkCounter::liveBytes();
+        BenchmarkCounter::resetPeakBytes();
+        window.show();
+        if (QTest::qWaitForWindowExposed(&window)) {
+            QTRY_VERIFY(frames.count() > 0);
+            if (window.rendererInterface()->graphicsApi() == QSGRendererInterface::OpenGL) {
+                qInfo("peak %llu KB, %llu KB in use after the upload",
+                      (BenchmarkCounter::peakBytes() - before) / 1024,
+                      (BenchmarkCounter::liveBytes() - before) / 1024);
+            } else {
+                qInfo("not using the OpenGL backend, nothing measured");
+            }
+        }
+    }
+
+    cache->setMaxBytes(cacheSize);
+    QQuickPathRenderer::setReleaseThreshold(threshold);
+}
+
+QTEST_MAIN(tst_Bench_Triangulation)
+
+#include "tst_bench_triangulation.moc"